@@ -4,54 +4,267 @@
  * @brief  Unrolled linked list implementation
  */
 #include <string.h>
-#include "ulist_api.h"
+#include <sys/mman.h>
+#include "ulist_internal.h"
 
-#define MIN_ITEMS_PER_NODE (2u)
 
-#define GREEDY (1u)
-#define NOT_GREEDY (0u)
+/**
+ * @see ulist_internal.h
+ */
+ulist_node_t *_alloc_node(ulist_t *list)
+{
+    return _alloc_sized_node(list, list->items_per_node);
+}
 
-#define MIN(x, y) (((x) < (y)) ? (x) : (y))
-#define MAX(x, y) (((x) > (y)) ? (x) : (y))
 
-#define NODE_ALLOC_SIZE(list) (sizeof(ulist_node_t) +       \
-                                   (list->item_size_bytes * \
-                                   list->items_per_node))
+// Offset of the first item from the start of each node of a list
+static size_t _items_offset(ulist_t *list)
+{
+    return (0u == list->data_alignment)
+           ? sizeof(ulist_node_t)
+           : ROUND_UP(sizeof(ulist_node_t), list->data_alignment);
+}
 
-#define NODE_DATA(list, node, i) (node->data + (list->item_size_bytes * (i)))
 
+// Number of bytes allocated for a node with room for capacity items
+static size_t _node_bytes(ulist_t *list, size_t capacity)
+{
+    size_t bytes = _items_offset(list) + (list->item_size_bytes * capacity);
 
-// Struct to hold parameters required to access a single data item in list
-typedef struct {
-    ulist_node_t *node;
-    size_t local_index;
-} access_params_t;
+    return (0u == list->node_alignment) ? bytes
+                                        : ROUND_UP(bytes, list->node_alignment);
+}
 
 
-// Allocate a new node and return a pointer to it
-static ulist_node_t *_alloc_new_node(ulist_t *list)
+/**
+ * @see ulist_internal.h
+ */
+ulist_node_t *_alloc_sized_node(ulist_t *list, size_t capacity)
 {
     ulist_node_t *node;
 
-    if ((node = malloc(NODE_ALLOC_SIZE(list))) == NULL)
+    // Nodes of spill lists all have the same size
+    if (NULL != list->spill)
+    {
+        return _spill_alloc_node(list);
+    }
+
+    size_t bytes = _node_bytes(list, capacity);
+
+    if (0u == list->node_alignment)
+    {
+        node = malloc(bytes);
+    }
+    else
+    {
+        node = aligned_alloc(list->node_alignment, bytes);
+    }
+
+    if (NULL == node)
+    {
+        return NULL;
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (bytes >= HUGE_PAGE_BYTES)
+    {
+        // Only a hint; nodes work the same without huge pages
+        (void) madvise(node, bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    memset(node, 0, sizeof(ulist_node_t));
+    node->refs = 1u;
+    node->capacity = capacity;
+    node->items = (char *) node + _items_offset(list);
+    return node;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _release_node(ulist_node_t *node)
+{
+    /* Only the last holder can see a count of 1, since new references are
+     * never taken while the list is being modified */
+    if ((1u == __atomic_load_n(&node->refs, __ATOMIC_ACQUIRE))
+        || (0u == __atomic_sub_fetch(&node->refs, 1u, __ATOMIC_ACQ_REL)))
+    {
+        if (NULL != node->owner)
+        {
+            _release_node(node->owner);
+        }
+
+        free(node);
+    }
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _free_node(ulist_t *list, ulist_node_t *node)
+{
+    if (NULL != list->spill)
+    {
+        _spill_free_node(list, node);
+        return;
+    }
+
+    _release_node(node);
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+ulist_node_t *_own_node(ulist_t *list, ulist_node_t *node)
+{
+    // Nodes of spill lists are never shared, but may need to be loaded
+    if (NULL != list->spill)
+    {
+        return _spill_use(list, node, 1) ? node : NULL;
+    }
+
+    if ((NULL == node->owner)
+        && (1u == __atomic_load_n(&node->refs, __ATOMIC_ACQUIRE)))
+    {
+        return node;
+    }
+
+    ulist_node_t *copy;
+
+    if ((copy = _alloc_sized_node(list, node->capacity)) == NULL)
     {
         return NULL;
     }
 
+    memcpy(copy->items, node->items, node->used * list->item_size_bytes);
+    copy->used = node->used;
+
+    // Snapshots and clones don't use these links, so the copy can be spliced
+    // in place
+    copy->next = node->next;
+    copy->previous = node->previous;
+
+    if (NULL != node->next)
+    {
+        node->next->previous = copy;
+    }
+
+    if (NULL != node->previous)
+    {
+        node->previous->next = copy;
+    }
+
+    if (list->head == node)
+    {
+        list->head = copy;
+    }
+
+    if (list->tail == node)
+    {
+        list->tail = copy;
+    }
+
+    if (list->current == node)
+    {
+        list->current = copy;
+    }
+
+    if (list->compact_node == node)
+    {
+        list->compact_node = copy;
+    }
+
+    _release_node(node);
+    return copy;
+}
+
+
+/* Make sure a node is not shared with a clone or snapshot before handing out
+ * writable pointers to its items, loading it first if it was spilled */
+static ulist_status_e _writable_node(ulist_t *list, ulist_node_t **node)
+{
+    ulist_node_t *owned;
+
+    if ((owned = _own_node(list, *node)) == NULL)
+    {
+        return (NULL != list->spill) ? ULIST_ERROR_IO : ULIST_ERROR_MEM;
+    }
+
+    *node = owned;
+    return ULIST_OK;
+}
+
+
+/* Add an empty node to the spare nodes of a list. Spare nodes always have
+ * room for list->items_per_node items. */
+static void _push_spare_node(ulist_t *list, ulist_node_t *node)
+{
+    size_t capacity = node->capacity;
+    char *items = node->items;
+
     memset(node, 0, sizeof(ulist_node_t));
+    node->refs = 1u;
+    node->capacity = capacity;
+    node->items = items;
+    node->next = list->spare;
+    list->spare = node;
+    list->spare_nodes += 1u;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _free_spare_nodes(ulist_t *list)
+{
+    while (NULL != list->spare)
+    {
+        ulist_node_t *node = list->spare;
+        list->spare = node->next;
+        _free_node(list, node);
+    }
+
+    list->spare_nodes = 0u;
+}
+
+
+/* Allocate a new node with room for capacity items, or take a spare one, and
+ * return a pointer to it */
+static ulist_node_t *_alloc_new_node(ulist_t *list, size_t capacity)
+{
+    ulist_node_t *node;
+
+    if ((NULL != list->spare) && (list->items_per_node == capacity))
+    {
+        node = list->spare;
+        list->spare = node->next;
+        list->spare_nodes -= 1u;
+        node->next = NULL;
+    }
+    else if ((node = _alloc_sized_node(list, capacity)) == NULL)
+    {
+        return NULL;
+    }
+
     list->nodes += 1;
+    STATS_ADD(list, nodes_allocated, 1u);
     return node;
 }
 
 
-/* Move items from src to dest until the number of items in dest has reached
- * more than half. dest and src are expected to be connected. */
-static void _balance_nodes(ulist_t *list, ulist_node_t *dest,
+/**
+ * @see ulist_internal.h
+ */
+void _balance_nodes(ulist_t *list, ulist_node_t *dest,
         ulist_node_t *src, unsigned greedy)
 {
     size_t items_to_move;
 
-    if (greedy && ((src->used + dest->used) <= list->items_per_node))
+    if (greedy && ((src->used + dest->used) <= dest->capacity))
     {
         // Data from both nodes can fit into one node
         items_to_move = src->used;
@@ -59,13 +272,18 @@ static void _balance_nodes(ulist_t *list, ulist_node_t *dest,
     }
     else
     {
-        size_t half_items = list->items_per_node / 2u;
-        size_t items_needed = half_items - dest->used;
+        // Half of the smaller node, so that neither node overflows
+        size_t half_items = MIN(dest->capacity, src->capacity) / 2u;
+        size_t items_needed = (half_items > dest->used)
+                              ? half_items - dest->used : 0u;
         items_to_move = MIN(items_needed, src->used);
     }
 
     size_t bytes_to_move = items_to_move * list->item_size_bytes;
 
+    STATS_ADD(list, balances, 1u);
+    STATS_ADD(list, bytes_moved, bytes_to_move);
+
     // Direction of copying
     unsigned head_to_tail = (src->next == dest) ? 1u : 0u;
 
@@ -75,25 +293,28 @@ static void _balance_nodes(ulist_t *list, ulist_node_t *dest,
         {
             // Existing data in dest, shift it to make room
             size_t dest_size = dest->used * list->item_size_bytes;
-            memmove(dest->data + bytes_to_move, dest->data, dest_size);
+            memmove(dest->items + bytes_to_move, dest->items, dest_size);
+            STATS_ADD(list, bytes_moved, dest_size);
         }
 
         // Move data from src to dest
         size_t src_index = src->used - items_to_move;
-        memcpy(dest->data, NODE_DATA(list, src, src_index), bytes_to_move);
+        memcpy(dest->items, NODE_DATA(list, src, src_index), bytes_to_move);
     }
     else
     {
         // Move data from src to dest
-        memcpy(NODE_DATA(list, dest, dest->used), src->data, bytes_to_move);
+        memcpy(NODE_DATA(list, dest, dest->used), src->items, bytes_to_move);
 
         if (items_to_move < src->used)
         {
             // Remaining data in src, move it back to cover the free space
             memmove(
-                src->data,
-                src->data + bytes_to_move,
+                src->items,
+                src->items + bytes_to_move,
                 (src->used - items_to_move) * list->item_size_bytes);
+            STATS_ADD(list, bytes_moved,
+                      (src->used - items_to_move) * list->item_size_bytes);
         }
     }
 
@@ -102,8 +323,10 @@ static void _balance_nodes(ulist_t *list, ulist_node_t *dest,
 }
 
 
-// Add item to a node that has space remaining -- no node allocation required
-static void _add_to_nonfull_node(ulist_t *list, access_params_t *params,
+/**
+ * @see ulist_internal.h
+ */
+void _add_to_nonfull_node(ulist_t *list, access_params_t *params,
     void *item)
 {
     // Target location to copy new item to
@@ -120,6 +343,7 @@ static void _add_to_nonfull_node(ulist_t *list, access_params_t *params,
 
         // Move items to make room for new items
         memmove(dest, target, bytes_to_move);
+        STATS_ADD(list, bytes_moved, bytes_to_move);
     }
 
     // Copy item to target location
@@ -135,11 +359,17 @@ static ulist_node_t *_add_to_full_node(ulist_t *list, access_params_t *params,
 {
     ulist_node_t *new = NULL;
 
-    if ((new = _alloc_new_node(list)) == NULL)
+    // Only a node split off the tail becomes an edge node
+    size_t capacity = (list->tail == params->node) ? list->edge_items_per_node
+                                                   : list->items_per_node;
+
+    if ((new = _alloc_new_node(list, capacity)) == NULL)
     {
         return NULL;
     }
 
+    STATS_ADD(list, splits, 1u);
+
     // Make sure new node is connected to full node's old neighbour
     if (params->node->next)
     {
@@ -173,6 +403,66 @@ static ulist_node_t *_add_to_full_node(ulist_t *list, access_params_t *params,
 }
 
 
+// Check if a full head or tail node is a small edge node that can be flushed
+static int _is_small_edge(ulist_t *list, ulist_node_t *node)
+{
+    return (node->capacity < list->items_per_node)
+           && (list->head != list->tail);
+}
+
+
+/* Empty a small head or tail node by moving all of its items into the interior
+ * node next to it, adding a new interior node first if that one has no room.
+ * Returns the emptied node, or NULL if allocation fails. */
+static ulist_node_t *_flush_edge_node(ulist_t *list, ulist_node_t *edge)
+{
+    int at_tail = (list->tail == edge);
+
+    if ((edge = _own_node(list, edge)) == NULL)
+    {
+        return NULL;
+    }
+
+    ulist_node_t *inner = (at_tail) ? edge->previous : edge->next;
+
+    if ((list->head == inner) || (list->tail == inner)
+        || ((inner->capacity - inner->used) < edge->used))
+    {
+        ulist_node_t *new;
+
+        if ((new = _alloc_new_node(list, list->items_per_node)) == NULL)
+        {
+            return NULL;
+        }
+
+        // Connect new node between the edge node and its old neighbour
+        if (at_tail)
+        {
+            new->previous = inner;
+            new->next = edge;
+            inner->next = new;
+            edge->previous = new;
+        }
+        else
+        {
+            new->previous = edge;
+            new->next = inner;
+            inner->previous = new;
+            edge->next = new;
+        }
+
+        inner = new;
+    }
+    else if ((inner = _own_node(list, inner)) == NULL)
+    {
+        return NULL;
+    }
+
+    _balance_nodes(list, inner, edge, GREEDY);
+    return edge;
+}
+
+
 // Add item to node at a specific index, creating a new node if required
 static ulist_status_e _insert_item(ulist_t *list, access_params_t *params,
     void *item)
@@ -183,15 +473,32 @@ static ulist_status_e _insert_item(ulist_t *list, access_params_t *params,
     // is not full, we can avoid some operations and just add the item at the
     // end of the previous node
     if ((params->local_index == 0u) && params->node->previous
-         && (params->node->previous->used < list->items_per_node))
+         && (params->node->previous->used < params->node->previous->capacity))
     {
         params->local_index = params->node->previous->used;
         params->node = params->node->previous;
+    }
+
+    if ((params->node = _own_node(list, params->node)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    if ((params->node->used == params->node->capacity)
+        && (0u == params->local_index) && (list->head == params->node)
+        && _is_small_edge(list, params->node))
+    {
+        // Full small head node, make room by moving its items inwards
+        if ((params->node = _flush_edge_node(list, params->node)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
         _add_to_nonfull_node(list, params, item);
     }
-    // Current node is full, create a new one
-    else if (params->node->used == list->items_per_node)
+    else if (params->node->used == params->node->capacity)
     {
+        // Current node is full, create a new one
         if ((new = _add_to_full_node(list, params, item)) == NULL)
         {
             return ULIST_ERROR_MEM;
@@ -229,15 +536,44 @@ static void _delete_node(ulist_t *list, ulist_node_t *node)
         list->tail = node->previous;
     }
 
-    free(node);
+    // Nodes before the one being deleted are still packed
+    if (list->compact_node == node)
+    {
+        list->compact_node = node->previous;
+    }
+
+    _free_node(list, node);
     list->nodes -= 1u;
+    STATS_ADD(list, merges, 1u);
 }
 
 
 /* Remove an item from the list. If the deleted item was the last one in the
  * node, then the empty node will be freed. */
-static void _remove_item(ulist_t *list, access_params_t *params)
+static ulist_status_e _remove_item(ulist_t *list, access_params_t *params)
 {
+    size_t half_items = params->node->capacity / 2u;
+
+    if ((params->node = _own_node(list, params->node)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    ulist_node_t *src_node = params->node->next;
+
+    if (NULL == params->node->next)
+    {
+        // Node is tail
+        src_node = params->node->previous;
+    }
+
+    // Source node needs to be writable too, if it will be balanced
+    if ((NULL != src_node) && ((params->node->used - 1u) <= half_items)
+        && ((src_node = _own_node(list, src_node)) == NULL))
+    {
+        return ULIST_ERROR_MEM;
+    }
+
     if (params->local_index != (params->node->used - 1u))
     {
         // Need to move some items into the freed space
@@ -248,29 +584,16 @@ static void _remove_item(ulist_t *list, access_params_t *params)
             NODE_DATA(list, params->node, params->local_index),
             NODE_DATA(list, params->node, params->local_index + 1u),
             bytes_to_move);
+        STATS_ADD(list, bytes_moved, bytes_to_move);
     }
 
     params->node->used -= 1u;
     list->num_items -= 1u;
-    size_t half_items = list->items_per_node / 2u;
-
-    if (params->node->used > half_items)
-    {
-        // Node is over half full, nothing else to do
-        return;
-    }
-
-    ulist_node_t *src_node = params->node->next;
 
-    if ((NULL == params->node->next) && (NULL == params->node->previous))
-    {
-        // Only node in the list, nothing else to do
-        return;
-    }
-    else if (NULL == params->node->next)
+    if ((params->node->used > half_items) || (NULL == src_node))
     {
-        // Node is tail
-        src_node = params->node->previous;
+        // Node is over half full, or is the only node; nothing else to do
+        return ULIST_OK;
     }
 
     // Move items from source node into current node
@@ -281,6 +604,8 @@ static void _remove_item(ulist_t *list, access_params_t *params)
         // Source node is empty
         _delete_node(list, src_node);
     }
+
+    return ULIST_OK;
 }
 
 
@@ -290,6 +615,7 @@ static void _forward_crawl(ulist_t *list, unsigned long long index,
 {
     ulist_node_t *node = list->head;
     unsigned long long item_count = 0u;
+    unsigned long long crawled = 0u;
 
     // Loop through nodes, incrementing item count until we reach target item
     while (NULL != node)
@@ -302,8 +628,13 @@ static void _forward_crawl(ulist_t *list, unsigned long long index,
         }
 
         node = node->next;
+        crawled += 1u;
     }
 
+    STATS_ADD(list, forward_crawls, 1u);
+    STATS_ADD(list, nodes_crawled, crawled);
+    (void) crawled;
+
     // Item index within node
     params->local_index = node->used - (item_count - index);
     params->node = node;
@@ -316,6 +647,7 @@ static void _backward_crawl(ulist_t *list, unsigned long long index,
 {
     ulist_node_t *node = list->tail;
     unsigned long long item_count = list->num_items;
+    unsigned long long crawled = 0u;
 
     // Loop through nodes, incrementing item count until we reach target item
     while (NULL != node)
@@ -328,8 +660,13 @@ static void _backward_crawl(ulist_t *list, unsigned long long index,
         }
 
         node = node->previous;
+        crawled += 1u;
     }
 
+    STATS_ADD(list, backward_crawls, 1u);
+    STATS_ADD(list, nodes_crawled, crawled);
+    (void) crawled;
+
     // Item index within node
     params->local_index = index - item_count;
     params->node = node;
@@ -367,11 +704,29 @@ static ulist_status_e _new_tail_item(ulist_t *list, void *item)
 {
     access_params_t params = {.node=list->tail, .local_index=list->tail->used};
 
-    // Tail node is full, create new
-    if (list->tail->used == list->items_per_node)
+    if (list->tail->used < list->tail->capacity)
+    {
+        // Tail node has room, but may be shared with a clone or snapshot
+        if ((params.node = _own_node(list, list->tail)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+    }
+    else if (_is_small_edge(list, list->tail))
+    {
+        // Small tail node, make room by moving its items inwards
+        if ((params.node = _flush_edge_node(list, list->tail)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        params.local_index = 0u;
+    }
+    else
     {
+        // Tail node is full, create new
         ulist_node_t *new;
-        if ((new = _alloc_new_node(list)) == NULL)
+        if ((new = _alloc_new_node(list, list->edge_items_per_node)) == NULL)
         {
             return ULIST_ERROR_MEM;
         }
@@ -382,7 +737,6 @@ static ulist_status_e _new_tail_item(ulist_t *list, void *item)
 
         params.node = new;
         params.local_index = 0u;
-
     }
 
     _add_to_nonfull_node(list, &params, item);
@@ -406,7 +760,7 @@ ulist_status_e ulist_node_size_bytes(ulist_t *list, size_t *size_bytes)
         return ULIST_INVALID_PARAM;
     }
 
-    *size_bytes = NODE_ALLOC_SIZE(list);
+    *size_bytes = _node_bytes(list, list->items_per_node);
 
     return ULIST_OK;
 }
@@ -415,25 +769,81 @@ ulist_status_e ulist_node_size_bytes(ulist_t *list, size_t *size_bytes)
 /**
  * @see ulist_api.h
  */
-ulist_status_e ulist_create(ulist_t *list, size_t item_size_bytes,
-    size_t items_per_node)
+ulist_status_e ulist_memory_report(ulist_t *list,
+    ulist_memory_report_t *report)
 {
-    if ((NULL == list) || (0u == item_size_bytes) || (0u == items_per_node))
+    if ((NULL == list) || (NULL == list->tail) || (NULL == report))
     {
         return ULIST_INVALID_PARAM;
     }
 
-    if (items_per_node < MIN_ITEMS_PER_NODE)
+    memset(report, 0, sizeof(ulist_memory_report_t));
+
+    for (ulist_node_t *node = list->head; NULL != node; node = node->next)
     {
-        return ULIST_INVALID_PARAM;
+        size_t item_bytes = node->used * list->item_size_bytes;
+
+        report->nodes += 1u;
+        report->header_bytes += sizeof(ulist_node_t);
+        report->item_bytes += item_bytes;
+
+        // Shared items, and items spilled to a file, take no memory here
+        if ((NULL == node->owner) && (NULL != node->items))
+        {
+            size_t node_bytes = _node_bytes(list, node->capacity);
+
+            // Any padding for alignment counts as unused
+            report->total_bytes += node_bytes;
+            report->unused_bytes += node_bytes - sizeof(ulist_node_t)
+                                    - item_bytes;
+        }
+        else
+        {
+            report->total_bytes += sizeof(ulist_node_t);
+        }
+
+        if (node->used < (node->capacity / 2u))
+        {
+            report->underfull_nodes += 1u;
+        }
+
+        size_t bucket = (node->used * ULIST_FILL_BUCKETS) / node->capacity;
+        report->fill_histogram[MIN(bucket, ULIST_FILL_BUCKETS - 1u)] += 1u;
     }
 
+    report->spare_nodes = list->spare_nodes;
+    report->total_bytes += list->spare_nodes
+                           * _node_bytes(list, list->items_per_node);
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_create(ulist_t *list, size_t item_size_bytes,
+    size_t items_per_node)
+{
+    return ulist_create_tiered(list, item_size_bytes, items_per_node,
+                               items_per_node);
+}
+
+
+// Initialize a list instance with validated node parameters
+static ulist_status_e _init_list(ulist_t *list, size_t item_size_bytes,
+    size_t edge_items_per_node, size_t items_per_node, size_t data_alignment,
+    size_t node_alignment)
+{
     memset(list, 0, sizeof(ulist_t));
     list->item_size_bytes = item_size_bytes;
     list->items_per_node = items_per_node;
+    list->edge_items_per_node = edge_items_per_node;
+    list->data_alignment = data_alignment;
+    list->node_alignment = node_alignment;
     list->current = NULL;
 
-    if ((list->head = _alloc_new_node(list)) == NULL)
+    if ((list->head = _alloc_new_node(list, edge_items_per_node)) == NULL)
     {
         return ULIST_ERROR_MEM;
     }
@@ -446,32 +856,174 @@ ulist_status_e ulist_create(ulist_t *list, size_t item_size_bytes,
 /**
  * @see ulist_api.h
  */
-ulist_status_e ulist_destroy(ulist_t *list)
+ulist_status_e ulist_create_tiered(ulist_t *list, size_t item_size_bytes,
+    size_t edge_items_per_node, size_t items_per_node)
 {
-    ulist_node_t *node, *old;
-    if (NULL == list)
+    if ((NULL == list) || (0u == item_size_bytes) || (0u == items_per_node))
     {
         return ULIST_INVALID_PARAM;
     }
 
-    if (NULL == list->head)
+    if ((edge_items_per_node < MIN_ITEMS_PER_NODE)
+        || (edge_items_per_node > items_per_node))
     {
-        return ULIST_ALREADY_DESTROYED;
+        return ULIST_INVALID_PARAM;
     }
 
-    if (list->head && list->tail)
+    return _init_list(list, item_size_bytes, edge_items_per_node,
+                      items_per_node, 0u, 0u);
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_create_aligned(ulist_t *list, size_t item_size_bytes,
+    size_t alignment, size_t node_bytes)
+{
+    if ((NULL == list) || (0u == item_size_bytes)
+        || (alignment < sizeof(void *))
+        || (0u != (alignment & (alignment - 1u)))
+        || (0u != (node_bytes % alignment)))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    size_t items_offset = ROUND_UP(sizeof(ulist_node_t), alignment);
+    size_t items_per_node = (node_bytes > items_offset)
+                            ? (node_bytes - items_offset) / item_size_bytes
+                            : 0u;
+
+    if (items_per_node < MIN_ITEMS_PER_NODE)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    // Page-sized nodes are aligned to their size, so each fills one page
+    size_t node_alignment = (0u == (node_bytes & (node_bytes - 1u)))
+                            ? node_bytes : alignment;
+
+    return _init_list(list, item_size_bytes, items_per_node, items_per_node,
+                      alignment, node_alignment);
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_destroy(ulist_t *list)
+{
+    ulist_node_t *node, *old;
+    if (NULL == list)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL != list->mapping)
+    {
+        munmap(list->mapping, list->mapping_size_bytes);
+        list->mapping = NULL;
+        return ULIST_OK;
+    }
+
+    if (NULL == list->head)
+    {
+        return ULIST_ALREADY_DESTROYED;
+    }
+
+    ulist_status_e err = ULIST_OK;
+
+    if (NULL != list->wal)
+    {
+        err = _wal_close(list);
+    }
+
+    _free_spare_nodes(list);
+    free(list->adapt);
+    list->adapt = NULL;
+
+    if (list->head && list->tail)
     {
         node = list->head;
         while (NULL != node)
         {
             old = node;
             node = node->next;
-            free(old);
+            _free_node(list, old);
         }
     }
 
+    if (NULL != list->spill)
+    {
+        _spill_destroy(list);
+    }
+
     list->head = NULL;
     list->tail = NULL;
+    return err;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_clone(ulist_t *list, ulist_t *clone)
+{
+    if ((NULL == list) || (NULL == list->tail) || (NULL == clone)
+        || (list == clone) || (NULL != list->spill))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_t new = *list;
+    new.head = NULL;
+    new.tail = NULL;
+    new.current = NULL;
+    new.wal = NULL;
+    new.compact_node = NULL;
+    new.spare = NULL;
+    new.spare_nodes = 0u;
+    new.adapt = NULL;
+
+#ifdef ULIST_STATS
+    memset(&new.stats, 0, sizeof(new.stats));
+#endif
+
+    for (ulist_node_t *node = list->head; NULL != node; node = node->next)
+    {
+        ulist_node_t *proxy;
+
+        // Header only; items stay in the node that owns them
+        if ((proxy = malloc(sizeof(ulist_node_t))) == NULL)
+        {
+            (void) ulist_destroy(&new);
+            return ULIST_ERROR_MEM;
+        }
+
+        ulist_node_t *owner = (NULL == node->owner) ? node : node->owner;
+        __atomic_add_fetch(&owner->refs, 1u, __ATOMIC_RELAXED);
+
+        memset(proxy, 0, sizeof(ulist_node_t));
+        proxy->refs = 1u;
+        proxy->used = node->used;
+        proxy->capacity = node->capacity;
+        proxy->items = owner->items;
+        proxy->owner = owner;
+        proxy->previous = new.tail;
+
+        if (NULL == new.head)
+        {
+            new.head = proxy;
+        }
+        else
+        {
+            new.tail->next = proxy;
+        }
+
+        new.tail = proxy;
+    }
+
+    *clone = new;
     return ULIST_OK;
 }
 
@@ -481,6 +1033,11 @@ ulist_status_e ulist_destroy(ulist_t *list)
  */
 ulist_status_e ulist_insert_item(ulist_t *list, unsigned long long index, void *item)
 {
+    if ((NULL != list) && (NULL != list->mapping))
+    {
+        return ULIST_READ_ONLY;
+    }
+
     if ((NULL == list) || (NULL == list->tail) || (NULL == item))
     {
         return ULIST_INVALID_PARAM;
@@ -491,6 +1048,16 @@ ulist_status_e ulist_insert_item(ulist_t *list, unsigned long long index, void *
         return ULIST_INDEX_OUT_OF_RANGE;
     }
 
+    if (NULL != list->wal)
+    {
+        return _wal_apply(list, WAL_OP_INSERT, index, item);
+    }
+
+    if (NULL != list->adapt)
+    {
+        _adapt_record(list, ADAPT_OP_INSERT, index);
+    }
+
     // Special case for index of list->num_items, call _new_tail_item
     if (index == list->num_items)
     {
@@ -508,16 +1075,231 @@ ulist_status_e ulist_insert_item(ulist_t *list, unsigned long long index, void *
 }
 
 
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_reserve(ulist_t *list, unsigned long long n_items)
+{
+    if ((NULL == list) || (NULL == list->tail) || (NULL != list->spill))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    unsigned long long tail_free = list->tail->capacity - list->tail->used;
+    unsigned long long nodes_needed = 0u;
+
+    if (n_items > tail_free)
+    {
+        nodes_needed = ((n_items - tail_free) + list->items_per_node - 1u)
+                       / list->items_per_node;
+    }
+
+    while (list->spare_nodes < nodes_needed)
+    {
+        ulist_node_t *node;
+
+        if ((node = _alloc_node(list)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        _push_spare_node(list, node);
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_shrink(ulist_t *list)
+{
+    if ((NULL == list) || (NULL == list->tail))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    _free_spare_nodes(list);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_clear(ulist_t *list, unsigned long long keep_nodes)
+{
+    if ((NULL != list) && (NULL != list->mapping))
+    {
+        return ULIST_READ_ONLY;
+    }
+
+    if ((NULL == list) || (NULL == list->tail))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL != list->wal)
+    {
+        return _wal_apply(list, WAL_OP_CLEAR, keep_nodes, NULL);
+    }
+
+    ulist_node_t *head = list->head;
+    ulist_node_t *node = head->next;
+
+    /* A shared head can't be emptied in place, and a head that is no longer a
+     * small edge node shouldn't stay the head, so they are replaced */
+    if ((NULL != head->owner) || (list->edge_items_per_node != head->capacity)
+        || (1u != __atomic_load_n(&head->refs, __ATOMIC_ACQUIRE)))
+    {
+        if ((head = _alloc_sized_node(list, list->edge_items_per_node)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        node = list->head;
+    }
+
+    while (NULL != node)
+    {
+        ulist_node_t *next = node->next;
+
+        if ((NULL == list->spill) && (NULL == node->owner)
+            && (list->items_per_node == node->capacity)
+            && (list->spare_nodes < keep_nodes)
+            && (1u == __atomic_load_n(&node->refs, __ATOMIC_ACQUIRE)))
+        {
+            _push_spare_node(list, node);
+        }
+        else
+        {
+            _free_node(list, node);
+        }
+
+        node = next;
+    }
+
+    head->next = NULL;
+    head->used = 0u;
+
+    list->head = head;
+    list->tail = head;
+    list->num_items = 0u;
+    list->nodes = 1u;
+    list->current = NULL;
+    list->compact_node = NULL;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_compact(ulist_t *list, size_t target_fill,
+    unsigned long long budget)
+{
+    if ((NULL != list) && (NULL != list->mapping))
+    {
+        return ULIST_READ_ONLY;
+    }
+
+    if ((NULL == list) || (NULL == list->tail)
+        || (target_fill > list->items_per_node))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (0u == target_fill)
+    {
+        target_fill = list->items_per_node;
+    }
+
+    ulist_node_t *dest = (NULL == list->compact_node) ? list->head
+                                                      : list->compact_node;
+    unsigned long long work = 0u;
+
+    list->current = NULL;
+
+    while (NULL != dest->next)
+    {
+        if ((0u != budget) && (work >= budget))
+        {
+            list->compact_node = dest;
+            return ULIST_IN_PROGRESS;
+        }
+
+        work += 1u;
+
+        if (dest->used >= MIN(target_fill, dest->capacity))
+        {
+            dest = dest->next;
+            continue;
+        }
+
+        ulist_node_t *owned;
+        ulist_node_t *src;
+
+        if (((owned = _own_node(list, dest)) == NULL)
+            || ((src = _own_node(list, owned->next)) == NULL))
+        {
+            list->compact_node = (NULL == owned) ? dest : owned;
+            return ULIST_ERROR_MEM;
+        }
+
+        dest = owned;
+
+        // Fill dest from the front of the next node
+        size_t fill = MIN(target_fill, dest->capacity);
+        size_t items_to_move = MIN(fill - dest->used, src->used);
+        size_t bytes_to_move = items_to_move * list->item_size_bytes;
+        size_t bytes_left = (src->used - items_to_move) * list->item_size_bytes;
+
+        memcpy(NODE_DATA(list, dest, dest->used), src->items, bytes_to_move);
+        memmove(src->items, src->items + bytes_to_move, bytes_left);
+        STATS_ADD(list, bytes_moved, bytes_to_move + bytes_left);
+
+        dest->used += items_to_move;
+        src->used -= items_to_move;
+        work += items_to_move;
+
+        if (0u == src->used)
+        {
+            _delete_node(list, src);
+        }
+    }
+
+    list->compact_node = NULL;
+    return ULIST_OK;
+}
+
+
 /**
  * @see ulist_api.h
  */
 ulist_status_e ulist_append_item(ulist_t *list, void *item)
 {
-    if ((NULL == list) || (NULL == item))
+    if ((NULL != list) && (NULL != list->mapping))
+    {
+        return ULIST_READ_ONLY;
+    }
+
+    if ((NULL == list) || (NULL == list->tail) || (NULL == item))
     {
         return ULIST_INVALID_PARAM;
     }
 
+    // Logged lists come back here with logging off, then record the append
+    if (NULL != list->wal)
+    {
+        return _wal_apply(list, WAL_OP_APPEND, list->num_items, item);
+    }
+
+    if (NULL != list->adapt)
+    {
+        _adapt_record(list, ADAPT_OP_APPEND, list->num_items);
+    }
+
     return _new_tail_item(list, item);
 }
 
@@ -528,7 +1310,8 @@ ulist_status_e ulist_append_item(ulist_t *list, void *item)
 ulist_status_e ulist_get_item(ulist_t *list, unsigned long long index,
     void *item)
 {
-    if ((NULL == list) || (NULL == list->tail) || (NULL == item))
+    if ((NULL == list) || (NULL == item)
+        || ((NULL == list->tail) && (NULL == list->mapping)))
     {
         return ULIST_INVALID_PARAM;
     }
@@ -538,6 +1321,17 @@ ulist_status_e ulist_get_item(ulist_t *list, unsigned long long index,
         return ULIST_INDEX_OUT_OF_RANGE;
     }
 
+    if (NULL != list->mapping)
+    {
+        memcpy(item, MAPPED_ITEM(list, index), list->item_size_bytes);
+        return ULIST_OK;
+    }
+
+    if (NULL != list->adapt)
+    {
+        _adapt_record(list, ADAPT_OP_GET, index);
+    }
+
     access_params_t params;
 
     if (_find_item_by_index(list, index, &params) == NULL)
@@ -545,6 +1339,11 @@ ulist_status_e ulist_get_item(ulist_t *list, unsigned long long index,
         return ULIST_ERROR_INTERNAL;
     }
 
+    if (!NODE_RESIDENT(list, params.node, 0))
+    {
+        return ULIST_ERROR_IO;
+    }
+
     void *data = NODE_DATA(list, params.node, params.local_index);
     memcpy(item, data, list->item_size_bytes);
 
@@ -552,12 +1351,60 @@ ulist_status_e ulist_get_item(ulist_t *list, unsigned long long index,
 }
 
 
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_get_item_pointer(ulist_t *list, unsigned long long index,
+    void **item)
+{
+    if ((NULL == list) || (NULL == item)
+        || ((NULL == list->tail) && (NULL == list->mapping)))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    if (NULL != list->mapping)
+    {
+        *item = MAPPED_ITEM(list, index);
+        return ULIST_OK;
+    }
+
+    if (NULL != list->adapt)
+    {
+        _adapt_record(list, ADAPT_OP_GET, index);
+    }
+
+    access_params_t params;
+
+    if (_find_item_by_index(list, index, &params) == NULL)
+    {
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    ulist_status_e status;
+
+    if ((status = _writable_node(list, &params.node)) != ULIST_OK)
+    {
+        return status;
+    }
+
+    *item = NODE_DATA(list, params.node, params.local_index);
+
+    return ULIST_OK;
+}
+
+
 /**
  * @see ulist_api.h
  */
 ulist_status_e ulist_get_next_item(ulist_t *list, void **item)
 {
-    if ((NULL == list) || (NULL == item))
+    if ((NULL == list) || (NULL == list->tail) || (NULL == item))
     {
         return ULIST_INVALID_PARAM;
     }
@@ -583,6 +1430,13 @@ ulist_status_e ulist_get_next_item(ulist_t *list, void **item)
         list->local_index = 0u;
     }
 
+    ulist_status_e status;
+
+    if ((status = _writable_node(list, &list->current)) != ULIST_OK)
+    {
+        return status;
+    }
+
     *item = NODE_DATA(list, list->current, list->local_index);
     list->local_index += 1u;
 
@@ -597,7 +1451,7 @@ ulist_status_e ulist_get_previous_item(ulist_t *list, void **item)
 {
     static int _end_reached = 0;
 
-    if ((NULL == list) || (NULL == item))
+    if ((NULL == list) || (NULL == list->tail) || (NULL == item))
     {
         return ULIST_INVALID_PARAM;
     }
@@ -621,6 +1475,13 @@ ulist_status_e ulist_get_previous_item(ulist_t *list, void **item)
         list->local_index = list->tail->used - 1u;
     }
 
+    ulist_status_e status;
+
+    if ((status = _writable_node(list, &list->current)) != ULIST_OK)
+    {
+        return status;
+    }
+
     *item = NODE_DATA(list, list->current, list->local_index);
 
     // Reached the end of this node-- jump to the previous one
@@ -652,7 +1513,7 @@ ulist_status_e ulist_get_previous_item(ulist_t *list, void **item)
 ulist_status_e ulist_set_iteration_start_index(ulist_t *list,
     unsigned long long index)
 {
-    if (NULL == list)
+    if ((NULL == list) || (NULL == list->tail))
     {
         return ULIST_INVALID_PARAM;
     }
@@ -676,11 +1537,172 @@ ulist_status_e ulist_set_iteration_start_index(ulist_t *list,
 }
 
 
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_iter_init(ulist_t *list, ulist_iter_t *iter,
+    unsigned long long index)
+{
+    if ((NULL == list) || (NULL == iter)
+        || ((NULL == list->tail) && (NULL == list->mapping)))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    iter->list = list;
+    iter->index = index;
+
+    if (0u == list->num_items)
+    {
+        // Nothing to iterate over
+        if (0u != index)
+        {
+            return ULIST_INDEX_OUT_OF_RANGE;
+        }
+
+        iter->node = NULL;
+        iter->local_index = 0u;
+        return ULIST_OK;
+    }
+
+    if (index >= list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    if (NULL != list->mapping)
+    {
+        // Items are found by index; there are no nodes to track
+        iter->node = NULL;
+        return ULIST_OK;
+    }
+
+    access_params_t params;
+
+    if (_find_item_by_index(list, index, &params) == NULL)
+    {
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    iter->node = params.node;
+    iter->local_index = params.local_index;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_iter_next(ulist_iter_t *iter, const void **item)
+{
+    if ((NULL == iter) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL != iter->list->mapping)
+    {
+        if (iter->index >= iter->list->num_items)
+        {
+            return ULIST_END;
+        }
+
+        *item = MAPPED_ITEM(iter->list, iter->index);
+        iter->index += 1u;
+        return ULIST_OK;
+    }
+
+    if (NULL == iter->node)
+    {
+        return ULIST_END;
+    }
+
+    // Reached the end of this node-- jump to the next one
+    while (iter->local_index >= iter->node->used)
+    {
+        if (NULL == iter->node->next)
+        {
+            iter->node = NULL;
+            return ULIST_END;
+        }
+
+        iter->node = iter->node->next;
+        iter->local_index = 0u;
+    }
+
+    if (!NODE_RESIDENT(iter->list, iter->node, 0))
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    *item = NODE_DATA(iter->list, iter->node, iter->local_index);
+    iter->local_index += 1u;
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_iter_previous(ulist_iter_t *iter, const void **item)
+{
+    if ((NULL == iter) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL != iter->list->mapping)
+    {
+        // Index wraps around past the head, which also ends the iteration
+        if (iter->index >= iter->list->num_items)
+        {
+            return ULIST_END;
+        }
+
+        *item = MAPPED_ITEM(iter->list, iter->index);
+        iter->index -= 1u;
+        return ULIST_OK;
+    }
+
+    if ((NULL == iter->node) || (iter->local_index >= iter->node->used))
+    {
+        iter->node = NULL;
+        return ULIST_END;
+    }
+
+    if (!NODE_RESIDENT(iter->list, iter->node, 0))
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    *item = NODE_DATA(iter->list, iter->node, iter->local_index);
+
+    // Reached the start of this node-- jump to the previous one
+    if (0u == iter->local_index)
+    {
+        iter->node = iter->node->previous;
+        iter->local_index = (NULL == iter->node) ? 0u : iter->node->used - 1u;
+    }
+    else
+    {
+        iter->local_index -= 1u;
+    }
+
+    return ULIST_OK;
+}
+
+
 /**
  * @see ulist_api.h
  */
 ulist_status_e ulist_pop_item(ulist_t *list, unsigned long long index, void *item)
 {
+    if ((NULL != list) && (NULL != list->mapping))
+    {
+        return ULIST_READ_ONLY;
+    }
+
     if ((NULL == list) || (NULL == list->tail))
     {
         return ULIST_INVALID_PARAM;
@@ -691,6 +1713,16 @@ ulist_status_e ulist_pop_item(ulist_t *list, unsigned long long index, void *ite
         return ULIST_INDEX_OUT_OF_RANGE;
     }
 
+    if (NULL != list->wal)
+    {
+        return _wal_apply(list, WAL_OP_POP, index, item);
+    }
+
+    if (NULL != list->adapt)
+    {
+        _adapt_record(list, ADAPT_OP_POP, index);
+    }
+
     access_params_t params;
 
     if (_find_item_by_index(list, index, &params) == NULL)
@@ -700,10 +1732,62 @@ ulist_status_e ulist_pop_item(ulist_t *list, unsigned long long index, void *ite
 
     if (NULL != item)
     {
+        if (!NODE_RESIDENT(list, params.node, 0))
+        {
+            return ULIST_ERROR_IO;
+        }
+
         void *data = NODE_DATA(list, params.node, params.local_index);
         memcpy(item, data, list->item_size_bytes);
     }
 
-    _remove_item(list, &params);
+    return _remove_item(list, &params);
+}
+
+
+#ifdef ULIST_STATS
+// Number of counters in ulist_stats_t, which only holds counters
+#define NUM_STATS (sizeof(ulist_stats_t) / sizeof(unsigned long long))
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_get_stats(ulist_t *list, ulist_stats_t *stats)
+{
+    if ((NULL == list) || (NULL == stats))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    unsigned long long *src = (unsigned long long *) &list->stats;
+    unsigned long long *dest = (unsigned long long *) stats;
+
+    for (size_t i = 0u; i < NUM_STATS; i++)
+    {
+        dest[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_api.h
+ */
+ulist_status_e ulist_reset_stats(ulist_t *list)
+{
+    if (NULL == list)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    unsigned long long *counters = (unsigned long long *) &list->stats;
+
+    for (size_t i = 0u; i < NUM_STATS; i++)
+    {
+        __atomic_store_n(&counters[i], 0u, __ATOMIC_RELAXED);
+    }
+
     return ULIST_OK;
 }
+#endif
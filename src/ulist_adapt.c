@@ -0,0 +1,287 @@
+/**
+ * @file   ulist_adapt.c
+ * @author Erik Nyquist
+ * @brief  Automatic tuning of the number of items per node
+ */
+#include <string.h>
+#include "ulist_adapt_api.h"
+#include "ulist_internal.h"
+
+
+// Fewest operations seen before a list is evaluated
+#define ADAPT_MIN_OPS (1024u)
+
+/* Rough costs of the steps that node capacity trades off against each other,
+ * in ns. Only their ratios matter. */
+#define CRAWL_NS_PER_NODE (2.0)
+#define MOVE_NS_PER_BYTE (0.05)
+#define ALLOC_NS (50.0)
+
+/* Fraction of the current cost that the best capacity must come in under
+ * before the list is rebuilt, so that lists don't flip between two sizes */
+#define ADAPT_MIN_GAIN (0.75)
+
+
+struct ulist_adapt {
+    size_t min_items_per_node;
+    size_t max_items_per_node;
+    unsigned long long ops;         // Operations since last evaluation
+    ulist_adapt_stats_t stats;
+};
+
+
+// Estimated cost of the operations seen so far, with items_per_node
+static double _cost(ulist_t *list, size_t items_per_node)
+{
+    ulist_adapt_stats_t *stats = &list->adapt->stats;
+    double nodes = (double) list->num_items / (double) items_per_node;
+
+    // Lookups start from the nearer end, crossing a quarter of the nodes on
+    // average, and shifts move half a node's items on average
+    return ((double) stats->lookups * (nodes / 4.0) * CRAWL_NS_PER_NODE)
+           + ((double) stats->shifts * (items_per_node / 2.0)
+              * (double) list->item_size_bytes * MOVE_NS_PER_BYTE)
+           + ((double) stats->appends * ALLOC_NS / (double) items_per_node);
+}
+
+
+// Rebuild a list with all items packed into nodes of a different capacity
+static ulist_status_e _rebuild(ulist_t *list, size_t items_per_node)
+{
+    size_t old_items_per_node = list->items_per_node;
+    unsigned long long num_nodes = (list->num_items + items_per_node - 1u)
+                                   / items_per_node;
+    ulist_node_t *head = NULL;
+    ulist_node_t *tail = NULL;
+
+    num_nodes = MAX(num_nodes, 1u);
+
+    // New nodes are allocated with the new capacity
+    list->items_per_node = items_per_node;
+    list->edge_items_per_node = items_per_node;
+
+    for (unsigned long long i = 0u; i < num_nodes; i++)
+    {
+        ulist_node_t *node;
+
+        if ((node = _alloc_node(list)) == NULL)
+        {
+            while (NULL != head)
+            {
+                node = head->next;
+                _free_node(list, head);
+                head = node;
+            }
+
+            list->items_per_node = old_items_per_node;
+            list->edge_items_per_node = old_items_per_node;
+            return ULIST_ERROR_MEM;
+        }
+
+        node->previous = tail;
+
+        if (NULL == tail)
+        {
+            head = node;
+        }
+        else
+        {
+            tail->next = node;
+        }
+
+        tail = node;
+    }
+
+    ulist_node_t *dest = head;
+    ulist_node_t *src = list->head;
+
+    while (NULL != src)
+    {
+        for (size_t copied = 0u; copied < src->used;)
+        {
+            if (dest->used == items_per_node)
+            {
+                dest = dest->next;
+            }
+
+            size_t items = MIN(src->used - copied, items_per_node - dest->used);
+
+            memcpy(NODE_DATA(list, dest, dest->used),
+                   NODE_DATA(list, src, copied),
+                   items * list->item_size_bytes);
+
+            dest->used += items;
+            copied += items;
+        }
+
+        ulist_node_t *next = src->next;
+        _free_node(list, src);
+        src = next;
+    }
+
+    // Spare nodes have the old capacity
+    _free_spare_nodes(list);
+
+    list->head = head;
+    list->tail = tail;
+    list->nodes = num_nodes;
+    list->current = NULL;
+    list->compact_node = NULL;
+    return ULIST_OK;
+}
+
+
+// Pick the best capacity for the operations seen, and rebuild if it pays off
+static void _evaluate(ulist_t *list)
+{
+    struct ulist_adapt *adapt = list->adapt;
+    size_t current = list->items_per_node;
+    size_t best = adapt->min_items_per_node;
+    double best_cost = _cost(list, best);
+
+    // A list that was created outside the limits is always moved into them
+    int in_limits = (current >= adapt->min_items_per_node)
+                    && (current <= adapt->max_items_per_node);
+
+    // Try the limits, and every power of 2 between them
+    for (size_t ipn = adapt->min_items_per_node;;)
+    {
+        double cost = _cost(list, ipn);
+
+        if (cost < best_cost)
+        {
+            best = ipn;
+            best_cost = cost;
+        }
+
+        if (ipn >= adapt->max_items_per_node)
+        {
+            break;
+        }
+
+        size_t next = 1u;
+        while (next <= ipn)
+        {
+            next <<= 1u;
+        }
+
+        ipn = MIN(next, adapt->max_items_per_node);
+    }
+
+    if ((best != current)
+        && (!in_limits
+            || (best_cost < (_cost(list, current) * ADAPT_MIN_GAIN)))
+        && (ULIST_OK == _rebuild(list, best)))
+    {
+        adapt->stats.rebuilds += 1u;
+    }
+
+    adapt->ops = 0u;
+    adapt->stats.lookups = 0u;
+    adapt->stats.shifts = 0u;
+    adapt->stats.appends = 0u;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _adapt_record(ulist_t *list, adapt_op_e op, unsigned long long index)
+{
+    struct ulist_adapt *adapt = list->adapt;
+    unsigned long long tail_start = list->num_items - list->tail->used;
+    int edge_node = (index < list->head->used) || (index >= tail_start);
+
+    switch (op)
+    {
+        case ADAPT_OP_APPEND:
+            adapt->stats.appends += 1u;
+            break;
+
+        case ADAPT_OP_GET:
+            adapt->stats.lookups += (edge_node) ? 0u : 1u;
+            break;
+
+        default:
+            // Inserting after, or popping, the last item moves nothing
+            if (index >= ((ADAPT_OP_INSERT == op) ? list->num_items
+                                                  : list->num_items - 1u))
+            {
+                adapt->stats.appends += 1u;
+            }
+            else
+            {
+                adapt->stats.shifts += 1u;
+                adapt->stats.lookups += (edge_node) ? 0u : 1u;
+            }
+            break;
+    }
+
+    adapt->ops += 1u;
+
+    // Only modifications rebuild the list, so item pointers stay valid
+    // between reads
+    if ((ADAPT_OP_GET != op)
+        && (adapt->ops >= MAX(list->num_items, ADAPT_MIN_OPS)))
+    {
+        _evaluate(list);
+    }
+}
+
+
+/**
+ * @see ulist_adapt_api.h
+ */
+ulist_status_e ulist_adapt_enable(ulist_t *list, size_t min_items_per_node,
+    size_t max_items_per_node)
+{
+    if ((NULL == list) || (NULL == list->tail) || (NULL != list->spill)
+        || (list->edge_items_per_node != list->items_per_node)
+        || (0u != list->node_alignment)
+        || (min_items_per_node < MIN_ITEMS_PER_NODE)
+        || (min_items_per_node > max_items_per_node))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if ((NULL == list->adapt)
+        && ((list->adapt = calloc(1u, sizeof(struct ulist_adapt))) == NULL))
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    list->adapt->min_items_per_node = min_items_per_node;
+    list->adapt->max_items_per_node = max_items_per_node;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_adapt_api.h
+ */
+ulist_status_e ulist_adapt_disable(ulist_t *list)
+{
+    if (NULL == list)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    free(list->adapt);
+    list->adapt = NULL;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_adapt_api.h
+ */
+ulist_status_e ulist_adapt_get_stats(ulist_t *list, ulist_adapt_stats_t *stats)
+{
+    if ((NULL == list) || (NULL == list->adapt) || (NULL == stats))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    *stats = list->adapt->stats;
+    return ULIST_OK;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file   ulist_adapt_api.h
+ * @author Erik Nyquist
+ * @brief  Automatic tuning of the number of items per node
+ *
+ * Larger nodes mean fewer nodes to crawl over when looking up an index, and
+ * fewer allocations when appending, but more items to shift on every insert
+ * or pop inside a node. Which size is best depends on how the list is used,
+ * and on how large it grows.
+ *
+ * With adaptive node capacity enabled, the list counts the lookups, shifts and
+ * appends caused by each operation. Once it has seen at least as many
+ * operations as it holds items (and some minimum), it estimates the cost of
+ * that operation mix for the current number of items per node and for the
+ * best number of items per node according to a simple cost model. If the best
+ * size is a clear improvement, the list is rebuilt with that many items per
+ * node. Rebuilding takes time proportional to the list size, but since a
+ * rebuild is only considered after that many operations, the cost per
+ * operation stays constant.
+ *
+ * Rebuilding invalidates item pointers and resets the iteration position used
+ * by #ulist_get_next_item and #ulist_get_previous_item. Adaptive lists can't
+ * be read from several threads at once, since reads are counted too. The
+ * typed list functions from ulist_typed_api.h pass everything through to the
+ * regular ulist API for adaptive lists.
+ */
+#ifndef ULIST_ADAPT_API_H
+#define ULIST_ADAPT_API_H
+
+#include "ulist_api.h"
+
+
+/* Counters for a list with adaptive node capacity */
+typedef struct {
+    unsigned long long lookups;     // Operations that crawled to an index
+    unsigned long long shifts;      // Operations that shifted items in a node
+    unsigned long long appends;     // Operations at the ends of the list
+    unsigned long long rebuilds;    // Times the list was rebuilt
+} ulist_adapt_stats_t;
+
+
+/**
+ * Enable adaptive node capacity for a list. The number of items per node is
+ * kept within the given limits, and is either one of the limits or a power
+ * of 2 when changed.
+ *
+ * @param    list                List instance
+ * @param    min_items_per_node  Smallest number of items per node to use
+ * @param    max_items_per_node  Largest number of items per node to use
+ *
+ * @return   ULIST_OK            If adaptive node capacity was enabled
+ * @return   ULIST_INVALID_PARAM If the limits are invalid, or list was
+ *                               created with ulist_spill_create, ulist_map,
+ *                               ulist_create_tiered or ulist_create_aligned
+ */
+ulist_status_e ulist_adapt_enable(ulist_t *list, size_t min_items_per_node,
+    size_t max_items_per_node);
+
+
+/**
+ * Disable adaptive node capacity for a list. The list keeps its current
+ * number of items per node.
+ *
+ * @param    list            List instance
+ *
+ * @return   ULIST_OK        If adaptive node capacity was disabled
+ */
+ulist_status_e ulist_adapt_disable(ulist_t *list);
+
+
+/**
+ * Fetch the counters of a list with adaptive node capacity. The operation
+ * counters cover the operations since the list was last evaluated.
+ *
+ * @param    list            List instance with adaptive node capacity enabled
+ * @param    stats           Pointer to write counters to
+ *
+ * @return   ULIST_OK        If the counters were fetched successfully
+ */
+ulist_status_e ulist_adapt_get_stats(ulist_t *list, ulist_adapt_stats_t *stats);
+
+
+#endif
@@ -9,6 +9,10 @@
 #include <stdlib.h>
 
 
+/* Size of a cache line, for keeping data written by different threads apart */
+#define ULIST_CACHE_LINE_BYTES (64u)
+
+
 /* Status codes for list operations */
 typedef enum {
     ULIST_OK,                 // Success
@@ -18,6 +22,11 @@ typedef enum {
     ULIST_INDEX_OUT_OF_RANGE, // Invalid list index provided
     ULIST_ERROR_MEM,          // Memory allocation failed
     ULIST_ERROR_INTERNAL,     // Unspecified internal error
+    ULIST_ERROR_IO,           // Reading or writing a file descriptor failed
+    ULIST_ERROR_FORMAT,       // Saved list data is invalid or truncated
+    ULIST_READ_ONLY,          // List can't be modified
+    ULIST_IN_PROGRESS,        // Work budget used up; call again to continue
+    ULIST_NOT_DURABLE,        // Done, but its log record could not be written
 } ulist_status_e;
 
 
@@ -28,16 +37,74 @@ struct ulist_node {
     struct ulist_node *next;
     struct ulist_node *previous;
     size_t used;
+    size_t capacity;    // Number of items the node has room for
+    unsigned int lock;  // Only used by lists created with ulist_fine_create
+    unsigned int refs;  // Holders of this node: the list, plus any snapshots
+    char *items;                // Item storage; data, or the data of owner
+    struct ulist_node *owner;   // Node whose data this node shares, if any
     char data[];
 };
 
 
+/* Spill-to-disk state; private to ulist_spill.c */
+struct ulist_spill;
+
+/* Write-ahead log state; private to ulist_wal.c */
+struct ulist_wal;
+
+/* Adaptive node capacity state; private to ulist_adapt.c */
+struct ulist_adapt;
+
+
+/* Number of buckets in the node fill histogram of a memory report */
+#define ULIST_FILL_BUCKETS (10u)
+
+
+/* Memory used by a list, as reported by ulist_memory_report. Nodes that share
+ * their items with a clone, or whose items are spilled to a file, only count
+ * their header towards total_bytes. */
+typedef struct {
+    unsigned long long nodes;
+    unsigned long long spare_nodes;      // Reserved nodes, not yet in use
+    unsigned long long total_bytes;      // Allocated for nodes, incl. spares
+    unsigned long long item_bytes;       // Holding live items
+    unsigned long long header_bytes;     // Taken up by node headers
+    unsigned long long unused_bytes;     // Item space or padding not holding
+                                         // items
+    unsigned long long underfull_nodes;  // Nodes less than half full
+
+    // Nodes by fill level; bucket i holds nodes that are at least
+    // i / ULIST_FILL_BUCKETS full, and full nodes are in the last bucket
+    unsigned long long fill_histogram[ULIST_FILL_BUCKETS];
+} ulist_memory_report_t;
+
+
+#ifdef ULIST_STATS
+/* Operation counters for a list, only available when built with ULIST_STATS.
+ * The counters are part of ulist_t, so the library and all code using it must
+ * be built with the same setting. */
+typedef struct {
+    unsigned long long forward_crawls;   // Index lookups starting at the head
+    unsigned long long backward_crawls;  // Index lookups starting at the tail
+    unsigned long long nodes_crawled;    // Nodes passed over by lookups
+    unsigned long long bytes_moved;      // Item bytes shifted or balanced
+    unsigned long long balances;         // Items moved between neighbours
+    unsigned long long splits;           // Full nodes split in two
+    unsigned long long merges;           // Nodes emptied into a neighbour
+    unsigned long long nodes_allocated;  // Nodes added to the list
+} ulist_stats_t;
+#endif
+
+
 /* Single ulist instance */
 typedef struct {
     ulist_node_t *head;
     ulist_node_t *tail;
     size_t item_size_bytes;
-    size_t items_per_node;
+    size_t items_per_node;          // Capacity of interior nodes
+    size_t edge_items_per_node;     // Capacity of nodes added at either end
+    size_t data_alignment;          // Alignment of node items, 0 if unaligned
+    size_t node_alignment;          // Alignment of nodes, 0 if unaligned
     unsigned long long num_items;
     unsigned long long nodes;
 
@@ -45,11 +112,72 @@ typedef struct {
     ulist_node_t *current;
     size_t local_index;
     unsigned long long index;
+
+    // Read-only file mapping, for lists created with ulist_map
+    char *mapping;
+    size_t mapping_size_bytes;
+
+    // Only set for lists created with ulist_spill_create
+    struct ulist_spill *spill;
+
+    // Only set for lists opened with ulist_wal_open
+    struct ulist_wal *wal;
+
+    // Next node to be filled by an incremental ulist_compact
+    ulist_node_t *compact_node;
+
+    // Empty nodes set aside by ulist_reserve, linked by their next pointers
+    ulist_node_t *spare;
+    unsigned long long spare_nodes;
+
+    // Only set for lists with adaptive node capacity, see ulist_adapt_enable
+    struct ulist_adapt *adapt;
+
+#ifdef ULIST_STATS
+    ulist_stats_t stats;
+#endif
 } ulist_t;
 
 
+/* External iteration state, allowing several iterations over the same list
+ * to be in progress at once without modifying the list instance */
+typedef struct {
+    ulist_t *list;
+    ulist_node_t *node;
+    size_t local_index;
+    unsigned long long index;  // Next item; only used for mapped lists
+} ulist_iter_t;
+
+
+#ifdef ULIST_STATS
 /**
- * Query the size of a node for a specific list.
+ * Fetch the operation counters of a list. Counters are updated with relaxed
+ * atomics, so they stay consistent for lists shared between threads, but may
+ * lag behind operations in progress.
+ *
+ * @param    list            List instance
+ * @param    stats           Pointer to write counters to
+ *
+ * @return   ULIST_OK        If the counters were fetched successfully
+ */
+ulist_status_e ulist_get_stats(ulist_t *list, ulist_stats_t *stats);
+
+
+/**
+ * Set all operation counters of a list to 0.
+ *
+ * @param    list            List instance
+ *
+ * @return   ULIST_OK        If the counters were reset successfully
+ */
+ulist_status_e ulist_reset_stats(ulist_t *list);
+#endif
+
+
+/**
+ * Query the size of a node for a specific list, including any padding for
+ * alignment. For lists created with #ulist_create_tiered, this is the size
+ * of an interior node.
  *
  * @param    list        List instance
  * @param    size_bytes  Pointer to write node size to
@@ -59,6 +187,21 @@ typedef struct {
 ulist_status_e ulist_node_size_bytes(ulist_t *list, size_t *size_bytes);
 
 
+/**
+ * Walk a list and report how much memory its nodes use, and how full they
+ * are. Heavy deletion in the middle of a list can leave many nodes around half
+ * full; the report shows how much memory that is costing.
+ *
+ * @param    list        List instance
+ * @param    report      Pointer to write report to
+ *
+ * @return   ULIST_OK            If the report was written successfully
+ * @return   ULIST_INVALID_PARAM If list is a mapped list, which has no nodes
+ */
+ulist_status_e ulist_memory_report(ulist_t *list,
+    ulist_memory_report_t *report);
+
+
 /**
  * Initialize a list instance.
  *
@@ -72,6 +215,58 @@ ulist_status_e ulist_create(ulist_t *list, size_t item_size_bytes,
     size_t items_per_node);
 
 
+/**
+ * Initialize a list instance whose nodes at the ends of the list are smaller
+ * than the ones in the middle. Deque traffic at the head and tail then only
+ * shifts items within small nodes, while the bulk of the list sits in large
+ * nodes that are cheap to scan and crawl over.
+ *
+ * When a small tail node fills up, its items are moved into the interior node
+ * before it (or into a new interior node, if that one is full), leaving the
+ * tail empty for the next appends. Inserting at index 0 into a full head node
+ * does the same towards the interior. Each node records its own capacity, so
+ * inserts and pops elsewhere in the list work as for any other list.
+ *
+ * @param    list                 Uninitialized list structure to initialize
+ * @param    item_size_bytes      Size of a single list item in bytes
+ * @param    edge_items_per_node  Number of items that nodes added at the head
+ *                                or tail of the list should hold
+ * @param    items_per_node       Number of items that interior nodes should
+ *                                hold; at least edge_items_per_node
+ *
+ * @return   ULIST_OK             If list instance was initialized successfully
+ */
+ulist_status_e ulist_create_tiered(ulist_t *list, size_t item_size_bytes,
+    size_t edge_items_per_node, size_t items_per_node);
+
+
+/**
+ * Initialize a list instance whose nodes are aligned in memory. The first item
+ * of each node starts on a multiple of alignment, such as the cache line size
+ * (#ULIST_CACHE_LINE_BYTES) or the width of the SIMD registers that will
+ * process the items, and the number of items per node is set to as many as
+ * fit in node_bytes, node header included.
+ *
+ * If node_bytes is a power of 2, such as a page (4096) or a huge page (2MB),
+ * nodes are also aligned to node_bytes, so that each node fills exactly one
+ * page. Nodes of 2MB or more are marked for transparent huge pages where the
+ * system supports it.
+ *
+ * @param    list            Uninitialized list structure to initialize
+ * @param    item_size_bytes Size of a single list item in bytes
+ * @param    alignment       Alignment of the first item in each node; a power
+ *                           of 2, at least sizeof(void *)
+ * @param    node_bytes      Size of each node in bytes; a multiple of
+ *                           alignment
+ *
+ * @return   ULIST_OK            If list instance was initialized successfully
+ * @return   ULIST_INVALID_PARAM If alignment or node_bytes are invalid, or
+ *                               fewer than 2 items fit in a node
+ */
+ulist_status_e ulist_create_aligned(ulist_t *list, size_t item_size_bytes,
+    size_t alignment, size_t node_bytes);
+
+
 /**
  * Destroy an initialized list instance. Memory will leak if all created list
  * instances are not destroyed.
@@ -79,10 +274,101 @@ ulist_status_e ulist_create(ulist_t *list, size_t item_size_bytes,
  * @param    list            List instance to destroy
  *
  * @return   ULIST_OK        If list instance was destroyed successfully
+ * @return   ULIST_ERROR_IO  If the list was opened with ulist_wal_open, and
+ *                           buffered log records could not be written. The
+ *                           list is destroyed regardless.
  */
 ulist_status_e ulist_destroy(ulist_t *list);
 
 
+/**
+ * Create a copy of a list that shares node data with the original. Each node
+ * of the clone refers to the data of the matching node in the original, so
+ * cloning only allocates node headers. When either list first modifies a
+ * shared node, that list gets its own copy of the node data; the other list
+ * is not affected. Lists sharing data can be destroyed in any order.
+ *
+ * @param    list            List instance to clone
+ * @param    clone           Uninitialized list structure to initialize
+ *
+ * @return   ULIST_OK        If the clone was created successfully
+ */
+ulist_status_e ulist_clone(ulist_t *list, ulist_t *clone);
+
+
+/**
+ * Set aside enough empty nodes for n_items more items to be appended without
+ * allocating memory. Nodes needed for inserts are also taken from the spare
+ * nodes while there are any. Spare nodes are kept until they are used, or
+ * until #ulist_shrink or #ulist_destroy is called.
+ *
+ * @param    list            List instance
+ * @param    n_items         Number of items to make room for
+ *
+ * @return   ULIST_OK            If the nodes were reserved successfully
+ * @return   ULIST_INVALID_PARAM If list was created with ulist_spill_create or
+ *                               ulist_map
+ * @return   ULIST_ERROR_MEM     If memory allocation failed. Nodes reserved
+ *                               before the failure are kept.
+ */
+ulist_status_e ulist_reserve(ulist_t *list, unsigned long long n_items);
+
+
+/**
+ * Free all spare nodes set aside by #ulist_reserve.
+ *
+ * @param    list            List instance
+ *
+ * @return   ULIST_OK        If the spare nodes were freed successfully
+ */
+ulist_status_e ulist_shrink(ulist_t *list);
+
+
+/**
+ * Remove all items from a list, keeping up to keep_nodes of its nodes (as
+ * spare nodes, see #ulist_reserve) so that refilling the list doesn't need
+ * to allocate them again. Nodes shared with snapshots or clones, and nodes of
+ * spill lists, are never kept. Clearing resets the iteration position used
+ * by #ulist_get_next_item and #ulist_get_previous_item.
+ *
+ * @param    list            List instance
+ * @param    keep_nodes      Maximum number of spare nodes to keep, including
+ *                           any spare nodes the list already had
+ *
+ * @return   ULIST_OK        If the list was cleared successfully
+ */
+ulist_status_e ulist_clear(ulist_t *list, unsigned long long keep_nodes);
+
+
+/**
+ * Repack the items of a list into as few nodes as possible, in one forward
+ * pass, and free the nodes that are left empty. Each node is filled up to
+ * target_fill items before moving on to the next; leaving some room free
+ * means the next few inserts into a node don't split it straight away.
+ *
+ * With a work budget, compaction stops once roughly that many items have been
+ * moved and nodes visited, and continues from the same point on the next
+ * call, so it can be spread out between other operations. The list can be
+ * modified between calls; nodes filled before the modification are not
+ * revisited. Compaction resets the iteration position used by
+ * #ulist_get_next_item and #ulist_get_previous_item.
+ *
+ * @param    list            List instance
+ * @param    target_fill     Number of items to fill each node up to, or 0 to
+ *                           fill nodes completely
+ * @param    budget          Maximum amount of work for this call, or 0 to
+ *                           compact the whole list in one call
+ *
+ * @return   ULIST_OK            If the list is fully compacted
+ * @return   ULIST_IN_PROGRESS   If the budget ran out before the end of the
+ *                               list was reached
+ * @return   ULIST_INVALID_PARAM If target_fill is larger than the number of
+ *                               items per node
+ */
+ulist_status_e ulist_compact(ulist_t *list, size_t target_fill,
+    unsigned long long budget);
+
+
 /**
  * Add an item to the end of a list.
  *
@@ -120,6 +406,26 @@ ulist_status_e ulist_get_item(ulist_t *list, unsigned long long index,
     void *item);
 
 
+/**
+ * Fetch a pointer to the item at a specific index in a list, instead of
+ * copying the item data out like #ulist_get_item does.
+ *
+ * @param    list            List instance
+ * @param    index           List index of item to fetch
+ * @param    item            Pointer to copy item pointer to. Note that this
+ *                           pointer may become invalid if items are added to or
+ *                           removed from the list. Items may be modified
+ *                           through this pointer; a node shared with a clone
+ *                           or snapshot is copied first, so those are not
+ *                           affected.
+ *
+ * @return   ULIST_OK        If item pointer was fetched successfully
+ * @return   ULIST_ERROR_MEM If a shared node could not be copied
+ */
+ulist_status_e ulist_get_item_pointer(ulist_t *list, unsigned long long index,
+    void **item);
+
+
 /**
  * Fetch the next item in the list, starting from the head item or from the
  * item at the iteration start index (if set). This is a much faster option for
@@ -131,10 +437,14 @@ ulist_status_e ulist_get_item(ulist_t *list, unsigned long long index,
  * @param    list            List instance
  * @param    item            Pointer to copy item pointer to. Note that this
  *                           pointer may become invalid if items are added to or
- *                           removed from the list.
+ *                           removed from the list. Items may be modified
+ *                           through this pointer; a node shared with a clone
+ *                           or snapshot is copied first, so those are not
+ *                           affected.
  *
  * @return   ULIST_OK        If next item was fetched successfully, or ULIST_END
  *                           if the end of the list has been reached
+ * @return   ULIST_ERROR_MEM If a shared node could not be copied
  */
 ulist_status_e ulist_get_next_item(ulist_t *list, void **item);
 
@@ -151,10 +461,14 @@ ulist_status_e ulist_get_next_item(ulist_t *list, void **item);
  * @param    list            List instance
  * @param    item            Pointer to copy item pointer to. Note that this
  *                           pointer may become invalid if items are added to or
- *                           removed from the list.
+ *                           removed from the list. Items may be modified
+ *                           through this pointer; a node shared with a clone
+ *                           or snapshot is copied first, so those are not
+ *                           affected.
  *
  * @return   ULIST_OK        If next item was fetched successfully, or ULIST_END
  *                           if the beginning of the list has been reached
+ * @return   ULIST_ERROR_MEM If a shared node could not be copied
  */
 ulist_status_e ulist_get_previous_item(ulist_t *list, void **item);
 
@@ -173,6 +487,61 @@ ulist_status_e ulist_set_iteration_start_index(ulist_t *list,
     unsigned long long index);
 
 
+/**
+ * Initialize an external iterator for a list. Unlike #ulist_get_next_item and
+ * #ulist_get_previous_item, the iteration state is kept in the iterator and not
+ * in the list instance, so a list that is not being modified can be iterated
+ * over by multiple readers at once.
+ *
+ * @param    list            List instance
+ * @param    iter            Iterator to initialize
+ * @param    index           List index of the item to be fetched by the first
+ *                           call to #ulist_iter_next or #ulist_iter_previous.
+ *                           May be 0 for an empty list.
+ *
+ * @return   ULIST_OK        If the iterator was initialized successfully
+ */
+ulist_status_e ulist_iter_init(ulist_t *list, ulist_iter_t *iter,
+    unsigned long long index);
+
+
+/**
+ * Fetch a pointer to the next item from an external iterator, and advance the
+ * iterator towards the tail of the list.
+ *
+ * @param    iter            Iterator initialized by #ulist_iter_init
+ * @param    item            Pointer to copy item pointer to. Note that this
+ *                           pointer may become invalid if items are added to or
+ *                           removed from the list. The item is read-only:
+ *                           iterators may be shared by concurrent readers and
+ *                           never copy nodes shared with a clone or snapshot,
+ *                           so use #ulist_get_item_pointer to modify items.
+ *
+ * @return   ULIST_OK        If next item was fetched successfully, or ULIST_END
+ *                           if the end of the list has been reached
+ */
+ulist_status_e ulist_iter_next(ulist_iter_t *iter, const void **item);
+
+
+/**
+ * Fetch a pointer to the previous item from an external iterator, and move the
+ * iterator towards the head of the list.
+ *
+ * @param    iter            Iterator initialized by #ulist_iter_init
+ * @param    item            Pointer to copy item pointer to. Note that this
+ *                           pointer may become invalid if items are added to or
+ *                           removed from the list. The item is read-only:
+ *                           iterators may be shared by concurrent readers and
+ *                           never copy nodes shared with a clone or snapshot,
+ *                           so use #ulist_get_item_pointer to modify items.
+ *
+ * @return   ULIST_OK        If previous item was fetched successfully, or
+ *                           ULIST_END if the beginning of the list has been
+ *                           reached
+ */
+ulist_status_e ulist_iter_previous(ulist_iter_t *iter, const void **item);
+
+
 /**
  * Fetch and remove an item from a specific index in a list.
  *
@@ -0,0 +1,657 @@
+/**
+ * @file   ulist_blob.c
+ * @author Erik Nyquist
+ * @brief  Unrolled linked list of variable-length items (blobs)
+ */
+#include <stdint.h>
+#include <string.h>
+#include "ulist_blob_api.h"
+#include "ulist_internal.h"
+
+
+// Smallest accepted node size
+#define MIN_NODE_BYTES (32u)
+
+// Size of a single entry in the offset table of a node
+#define OFFSET_BYTES (sizeof(uint32_t))
+
+// Round a number of bytes up to a whole number of offset table entries
+#define ROUND_BYTES(n) (((n) + OFFSET_BYTES - 1u) & ~(OFFSET_BYTES - 1u))
+
+// Bytes taken up by the blobs of a node, including their offsets
+#define OCCUPIED_BYTES(node) ((node)->used_bytes + \
+                              ((node)->used * OFFSET_BYTES))
+
+// Bytes still free in a node
+#define FREE_BYTES(node) ((node)->capacity_bytes - OCCUPIED_BYTES(node))
+
+
+/* Offset table of a node. Entry i is where blob i starts in node->data; a
+ * blob ends where the next one starts, or at node->used_bytes. */
+static uint32_t *_offsets(ulist_blob_node_t *node)
+{
+    return (uint32_t *) (node->data + node->capacity_bytes
+                         - (node->used * OFFSET_BYTES));
+}
+
+
+// Start of the blob at local index i, or the end of the data if i == used
+static size_t _blob_start(ulist_blob_node_t *node, size_t i)
+{
+    return (i < node->used) ? _offsets(node)[i] : node->used_bytes;
+}
+
+
+/* Bytes taken up by the blobs from local index i to the end of a node,
+ * including their offsets */
+static size_t _bytes_from(ulist_blob_node_t *node, size_t i)
+{
+    return (node->used_bytes - _blob_start(node, i))
+           + ((node->used - i) * OFFSET_BYTES);
+}
+
+
+static ulist_blob_node_t *_alloc_blob_node(ulist_blob_t *list,
+    size_t capacity_bytes)
+{
+    ulist_blob_node_t *node;
+
+    capacity_bytes = ROUND_BYTES(capacity_bytes);
+
+    if ((node = malloc(sizeof(ulist_blob_node_t) + capacity_bytes)) == NULL)
+    {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(ulist_blob_node_t));
+    node->capacity_bytes = capacity_bytes;
+    list->nodes += 1u;
+    return node;
+}
+
+
+// Connect a new node after node, or before it if after is 0
+static void _link_node(ulist_blob_t *list, ulist_blob_node_t *node,
+    ulist_blob_node_t *new, int after)
+{
+    if (after)
+    {
+        new->previous = node;
+        new->next = node->next;
+
+        if (NULL != node->next)
+        {
+            node->next->previous = new;
+        }
+        else
+        {
+            list->tail = new;
+        }
+
+        node->next = new;
+    }
+    else
+    {
+        new->next = node;
+        new->previous = node->previous;
+
+        if (NULL != node->previous)
+        {
+            node->previous->next = new;
+        }
+        else
+        {
+            list->head = new;
+        }
+
+        node->previous = new;
+    }
+}
+
+
+// Free an empty node and connect the nodes on either side of it
+static void _delete_node(ulist_blob_t *list, ulist_blob_node_t *node)
+{
+    if (NULL != node->next)
+    {
+        node->next->previous = node->previous;
+    }
+    else
+    {
+        list->tail = node->previous;
+    }
+
+    if (NULL != node->previous)
+    {
+        node->previous->next = node->next;
+    }
+    else
+    {
+        list->head = node->next;
+    }
+
+    free(node);
+    list->nodes -= 1u;
+}
+
+
+// Add a blob at local index i of a node with enough free space
+static void _node_insert(ulist_blob_node_t *node, size_t i, const void *blob,
+    size_t size_bytes)
+{
+    uint32_t *old = _offsets(node);
+    uint32_t *new = old - 1;
+    size_t start = _blob_start(node, i);
+
+    // Make room in the data for the new blob
+    memmove(node->data + start + size_bytes, node->data + start,
+            node->used_bytes - start);
+
+    if (size_bytes > 0u)
+    {
+        memcpy(node->data + start, blob, size_bytes);
+    }
+
+    /* The table grows down by one entry; entries after i stay where they are,
+     * and become entries i + 1 onwards */
+    memmove(new, old, i * OFFSET_BYTES);
+    new[i] = (uint32_t) start;
+
+    for (size_t j = i + 1u; j <= node->used; j++)
+    {
+        new[j] += (uint32_t) size_bytes;
+    }
+
+    node->used += 1u;
+    node->used_bytes += size_bytes;
+}
+
+
+// Remove the blob at local index i of a node, copying it to blob if not NULL
+static void _node_remove(ulist_blob_node_t *node, size_t i, void *blob)
+{
+    uint32_t *old = _offsets(node);
+    size_t start = old[i];
+    size_t end = _blob_start(node, i + 1u);
+    size_t size_bytes = end - start;
+
+    if ((NULL != blob) && (size_bytes > 0u))
+    {
+        memcpy(blob, node->data + start, size_bytes);
+    }
+
+    memmove(node->data + start, node->data + end, node->used_bytes - end);
+
+    /* The table shrinks by one entry; entries after i stay where they are,
+     * and become entries i onwards */
+    for (size_t j = i + 1u; j < node->used; j++)
+    {
+        old[j] -= (uint32_t) size_bytes;
+    }
+
+    memmove(old + 1, old, i * OFFSET_BYTES);
+
+    node->used -= 1u;
+    node->used_bytes -= size_bytes;
+}
+
+
+/* Move the first count blobs of src to the end of dest. dest comes right
+ * before src, and must have room for them. */
+static void _move_head_blobs(ulist_blob_node_t *dest, ulist_blob_node_t *src,
+    size_t count)
+{
+    uint32_t *src_offsets = _offsets(src);
+    uint32_t *old = _offsets(dest);
+    uint32_t *new = old - count;
+    size_t bytes = _blob_start(src, count);
+
+    memcpy(dest->data + dest->used_bytes, src->data, bytes);
+    memmove(src->data, src->data + bytes, src->used_bytes - bytes);
+
+    memmove(new, old, dest->used * OFFSET_BYTES);
+
+    for (size_t k = 0u; k < count; k++)
+    {
+        new[dest->used + k] = src_offsets[k] + (uint32_t) dest->used_bytes;
+    }
+
+    // Remaining entries of src stay in place
+    for (size_t k = count; k < src->used; k++)
+    {
+        src_offsets[k] -= (uint32_t) bytes;
+    }
+
+    dest->used += count;
+    dest->used_bytes += bytes;
+    src->used -= count;
+    src->used_bytes -= bytes;
+}
+
+
+/* Move the last count blobs of src to the start of dest. src comes right
+ * before dest, and dest must have room for them. */
+static void _move_tail_blobs(ulist_blob_node_t *src, ulist_blob_node_t *dest,
+    size_t count)
+{
+    uint32_t *src_offsets = _offsets(src);
+    uint32_t *new = _offsets(dest) - count;
+    size_t first = src->used - count;
+    size_t start = src_offsets[first];
+    size_t bytes = src->used_bytes - start;
+
+    memmove(dest->data + bytes, dest->data, dest->used_bytes);
+    memcpy(dest->data, src->data + start, bytes);
+
+    // Existing entries of dest stay in place, and move up by count
+    for (size_t k = 0u; k < count; k++)
+    {
+        new[k] = src_offsets[first + k] - (uint32_t) start;
+    }
+
+    for (size_t k = count; k < (count + dest->used); k++)
+    {
+        new[k] += (uint32_t) bytes;
+    }
+
+    memmove(src_offsets + count, src_offsets, first * OFFSET_BYTES);
+
+    dest->used += count;
+    dest->used_bytes += bytes;
+    src->used -= count;
+    src->used_bytes -= bytes;
+}
+
+
+// Find the node holding a blob, and the blob's index within that node
+static ulist_blob_node_t *_find_blob(ulist_blob_t *list,
+    unsigned long long index, size_t *local_index)
+{
+    ulist_blob_node_t *node;
+
+    if (index < (list->num_items / 2u))
+    {
+        for (node = list->head; index >= node->used; node = node->next)
+        {
+            index -= node->used;
+        }
+
+        *local_index = (size_t) index;
+    }
+    else
+    {
+        unsigned long long start = list->num_items - list->tail->used;
+
+        for (node = list->tail; index < start; node = node->previous)
+        {
+            start -= node->previous->used;
+        }
+
+        *local_index = (size_t) (index - start);
+    }
+
+    return node;
+}
+
+
+/* Put a blob in a new node of its own at local index i of node, splitting
+ * node first if i is in the middle of it */
+static ulist_status_e _insert_new_node(ulist_blob_t *list,
+    ulist_blob_node_t *node, size_t i, const void *blob, size_t size_bytes)
+{
+    ulist_blob_node_t *new;
+
+    if ((0u < i) && (i < node->used))
+    {
+        /* node may be oversized, after holding a large blob or taking blobs
+         * from a neighbour, so the blobs after i may not fit a regular node */
+        size_t capacity = MAX(list->node_bytes, _bytes_from(node, i));
+
+        if ((new = _alloc_blob_node(list, capacity)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        _link_node(list, node, new, 1);
+        _move_tail_blobs(node, new, node->used - i);
+    }
+
+    size_t capacity = MAX(list->node_bytes, size_bytes + OFFSET_BYTES);
+
+    if ((new = _alloc_blob_node(list, capacity)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    _link_node(list, node, new, (0u != i));
+    _node_insert(new, 0u, blob, size_bytes);
+
+    // Only the node of an empty list can be empty, and it is now replaced
+    if (0u == node->used)
+    {
+        _delete_node(list, node);
+    }
+
+    return ULIST_OK;
+}
+
+
+// Index at which to split a node so that each half has about as many bytes
+static size_t _split_index(ulist_blob_node_t *node)
+{
+    uint32_t *offsets = _offsets(node);
+    size_t half = OCCUPIED_BYTES(node) / 2u;
+    size_t k = 1u;
+
+    // Bytes before blob k, including offsets, are offsets[k] + k entries
+    while ((k < (node->used - 1u))
+           && ((offsets[k] + (k * OFFSET_BYTES)) < half))
+    {
+        k += 1u;
+    }
+
+    return k;
+}
+
+
+// Add a blob at local index i of a node, making room for it if required
+static ulist_status_e _insert_blob(ulist_blob_t *list, ulist_blob_node_t *node,
+    size_t i, const void *blob, size_t size_bytes)
+{
+    size_t needed = size_bytes + OFFSET_BYTES;
+
+    if (FREE_BYTES(node) >= needed)
+    {
+        _node_insert(node, i, blob, size_bytes);
+        return ULIST_OK;
+    }
+
+    // Blob goes at the boundary with a neighbour that has room for it
+    if ((0u == i) && (NULL != node->previous)
+        && (FREE_BYTES(node->previous) >= needed))
+    {
+        _node_insert(node->previous, node->previous->used, blob, size_bytes);
+        return ULIST_OK;
+    }
+
+    if ((node->used == i) && (NULL != node->next)
+        && (FREE_BYTES(node->next) >= needed))
+    {
+        _node_insert(node->next, 0u, blob, size_bytes);
+        return ULIST_OK;
+    }
+
+    /* Split the node in half by bytes, and see if the blob fits in a half.
+     * Appends start a new tail node instead, leaving the old one full. */
+    if ((needed <= list->node_bytes) && (node->used >= 2u)
+        && ((list->tail != node) || (node->used != i)))
+    {
+        ulist_blob_node_t *new;
+        size_t k = _split_index(node);
+
+        // The second half of an oversized node may not fit a regular node
+        size_t capacity = MAX(list->node_bytes, _bytes_from(node, k));
+
+        if ((new = _alloc_blob_node(list, capacity)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        _link_node(list, node, new, 1);
+        _move_tail_blobs(node, new, node->used - k);
+
+        if ((i > k) || ((i == k) && (FREE_BYTES(node) < needed)))
+        {
+            node = new;
+            i -= k;
+        }
+
+        if (FREE_BYTES(node) >= needed)
+        {
+            _node_insert(node, i, blob, size_bytes);
+            return ULIST_OK;
+        }
+    }
+
+    return _insert_new_node(list, node, i, blob, size_bytes);
+}
+
+
+/* After a pop, fill an underfull node from a neighbour, or merge the two if
+ * they fit in one node */
+static void _balance_blob_nodes(ulist_blob_t *list, ulist_blob_node_t *node)
+{
+    ulist_blob_node_t *src = (NULL != node->next) ? node->next
+                                                  : node->previous;
+
+    if ((NULL == src) || (OCCUPIED_BYTES(node) >= (node->capacity_bytes / 2u)))
+    {
+        return;
+    }
+
+    if (OCCUPIED_BYTES(src) <= FREE_BYTES(node))
+    {
+        if (src == node->next)
+        {
+            _move_head_blobs(node, src, src->used);
+        }
+        else
+        {
+            _move_tail_blobs(src, node, src->used);
+        }
+
+        _delete_node(list, src);
+        return;
+    }
+
+    // Take whole blobs from the near end of src until node is half full
+    uint32_t *offsets = _offsets(src);
+    size_t half = node->capacity_bytes / 2u;
+    size_t occupied = OCCUPIED_BYTES(node);
+    size_t count = 0u;
+
+    while ((count < (src->used - 1u)) && (occupied < half))
+    {
+        size_t k = (src == node->next) ? count : src->used - 1u - count;
+        size_t needed = (_blob_start(src, k + 1u) - offsets[k]) + OFFSET_BYTES;
+
+        if (needed > (node->capacity_bytes - occupied))
+        {
+            break;
+        }
+
+        occupied += needed;
+        count += 1u;
+    }
+
+    if (0u == count)
+    {
+        return;
+    }
+
+    if (src == node->next)
+    {
+        _move_head_blobs(node, src, count);
+    }
+    else
+    {
+        _move_tail_blobs(src, node, count);
+    }
+}
+
+
+/**
+ * @see ulist_blob_api.h
+ */
+ulist_status_e ulist_blob_create(ulist_blob_t *list, size_t node_bytes)
+{
+    if ((NULL == list) || (node_bytes < MIN_NODE_BYTES)
+        || (node_bytes > UINT32_MAX))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    memset(list, 0, sizeof(ulist_blob_t));
+    list->node_bytes = ROUND_BYTES(node_bytes);
+
+    if ((list->head = _alloc_blob_node(list, list->node_bytes)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    list->tail = list->head;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_blob_api.h
+ */
+ulist_status_e ulist_blob_destroy(ulist_blob_t *list)
+{
+    if (NULL == list)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL == list->head)
+    {
+        return ULIST_ALREADY_DESTROYED;
+    }
+
+    ulist_blob_node_t *node = list->head;
+
+    while (NULL != node)
+    {
+        ulist_blob_node_t *next = node->next;
+        free(node);
+        node = next;
+    }
+
+    memset(list, 0, sizeof(ulist_blob_t));
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_blob_api.h
+ */
+ulist_status_e ulist_blob_append(ulist_blob_t *list, const void *blob,
+    size_t size_bytes)
+{
+    return ulist_blob_insert(list, (NULL == list) ? 0u : list->num_items,
+                             blob, size_bytes);
+}
+
+
+/**
+ * @see ulist_blob_api.h
+ */
+ulist_status_e ulist_blob_insert(ulist_blob_t *list, unsigned long long index,
+    const void *blob, size_t size_bytes)
+{
+    if ((NULL == list) || (NULL == list->head)
+        || ((NULL == blob) && (0u != size_bytes))
+        || (size_bytes > (UINT32_MAX - list->node_bytes)))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index > list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    ulist_blob_node_t *node = list->tail;
+    size_t local_index = node->used;
+
+    if (index < list->num_items)
+    {
+        node = _find_blob(list, index, &local_index);
+    }
+
+    ulist_status_e err = _insert_blob(list, node, local_index, blob,
+                                      size_bytes);
+
+    if (ULIST_OK == err)
+    {
+        list->num_items += 1u;
+    }
+
+    return err;
+}
+
+
+/**
+ * @see ulist_blob_api.h
+ */
+ulist_status_e ulist_blob_get(ulist_blob_t *list, unsigned long long index,
+    void **blob, size_t *size_bytes)
+{
+    if ((NULL == list) || (NULL == list->head) || (NULL == blob)
+        || (NULL == size_bytes))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    size_t i;
+    ulist_blob_node_t *node = _find_blob(list, index, &i);
+    size_t start = _offsets(node)[i];
+
+    *blob = node->data + start;
+    *size_bytes = _blob_start(node, i + 1u) - start;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_blob_api.h
+ */
+ulist_status_e ulist_blob_pop(ulist_blob_t *list, unsigned long long index,
+    void *blob, size_t *size_bytes)
+{
+    if ((NULL == list) || (NULL == list->head)
+        || ((NULL != blob) && (NULL == size_bytes)))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    size_t i;
+    ulist_blob_node_t *node = _find_blob(list, index, &i);
+    size_t blob_bytes = _blob_start(node, i + 1u) - _offsets(node)[i];
+
+    if ((NULL != blob) && (*size_bytes < blob_bytes))
+    {
+        *size_bytes = blob_bytes;
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL != size_bytes)
+    {
+        *size_bytes = blob_bytes;
+    }
+
+    _node_remove(node, i, blob);
+    list->num_items -= 1u;
+
+    if ((0u == node->used) && (list->head != list->tail))
+    {
+        _delete_node(list, node);
+    }
+    else
+    {
+        _balance_blob_nodes(list, node);
+    }
+
+    return ULIST_OK;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file   ulist_blob_api.h
+ * @author Erik Nyquist
+ * @brief  Unrolled linked list of variable-length items (blobs)
+ *
+ * A blob list stores items of any size, such as strings, directly in its
+ * nodes instead of in separate allocations. Each node is a fixed-size byte
+ * region: blob data is packed from the start of the region, and a table with
+ * the offset of each blob grows down from the end. A node is full when the
+ * two meet.
+ *
+ * Nodes are split and merged by byte occupancy, the same way regular lists
+ * split and merge nodes by item count. A node that has no room for a new blob
+ * is split roughly in half by bytes, and a node that drops below half full
+ * after a pop takes blobs from, or is merged with, a neighbour. A blob that is
+ * too large for a regular node gets a node of its own, sized to fit it.
+ */
+#ifndef ULIST_BLOB_API_H
+#define ULIST_BLOB_API_H
+
+#include "ulist_api.h"
+
+
+/* Single node in a blob list */
+typedef struct ulist_blob_node ulist_blob_node_t;
+
+struct ulist_blob_node {
+    struct ulist_blob_node *next;
+    struct ulist_blob_node *previous;
+    size_t used;              // Number of blobs in the node
+    size_t used_bytes;        // Bytes of blob data, not counting offsets
+    size_t capacity_bytes;    // Size of data
+    char data[];
+};
+
+
+/* Single blob list instance */
+typedef struct {
+    ulist_blob_node_t *head;
+    ulist_blob_node_t *tail;
+    size_t node_bytes;
+    unsigned long long num_items;
+    unsigned long long nodes;
+} ulist_blob_t;
+
+
+/**
+ * Initialize a blob list instance.
+ *
+ * @param    list            Uninitialized list structure to initialize
+ * @param    node_bytes      Number of bytes of blobs and offsets that each
+ *                           node should hold; at least 32
+ *
+ * @return   ULIST_OK        If list instance was initialized successfully
+ */
+ulist_status_e ulist_blob_create(ulist_blob_t *list, size_t node_bytes);
+
+
+/**
+ * Destroy an initialized blob list instance.
+ *
+ * @param    list            List instance to destroy
+ *
+ * @return   ULIST_OK        If list instance was destroyed successfully
+ */
+ulist_status_e ulist_blob_destroy(ulist_blob_t *list);
+
+
+/**
+ * Add a blob to the end of a list.
+ *
+ * @param    list            List instance
+ * @param    blob            Pointer to blob data; may be NULL if size_bytes
+ *                           is 0
+ * @param    size_bytes      Size of the blob in bytes
+ *
+ * @return   ULIST_OK        If blob was added successfully
+ */
+ulist_status_e ulist_blob_append(ulist_blob_t *list, const void *blob,
+    size_t size_bytes);
+
+
+/**
+ * Insert a blob at a specific index in a list.
+ *
+ * @param    list            List instance
+ * @param    index           List index to insert the blob at
+ * @param    blob            Pointer to blob data; may be NULL if size_bytes
+ *                           is 0
+ * @param    size_bytes      Size of the blob in bytes
+ *
+ * @return   ULIST_OK        If blob was inserted successfully
+ */
+ulist_status_e ulist_blob_insert(ulist_blob_t *list, unsigned long long index,
+    const void *blob, size_t size_bytes);
+
+
+/**
+ * Fetch a pointer to the blob at a specific index in a list, along with its
+ * size.
+ *
+ * @param    list            List instance
+ * @param    index           List index of blob to fetch
+ * @param    blob            Pointer to copy blob pointer to. Note that this
+ *                           pointer may become invalid if blobs are added to
+ *                           or removed from the list.
+ * @param    size_bytes      Pointer to write blob size to
+ *
+ * @return   ULIST_OK        If blob pointer was fetched successfully
+ */
+ulist_status_e ulist_blob_get(ulist_blob_t *list, unsigned long long index,
+    void **blob, size_t *size_bytes);
+
+
+/**
+ * Remove the blob at a specific index in a list, optionally copying it out.
+ *
+ * @param    list            List instance
+ * @param    index           List index of blob to remove
+ * @param    blob            Buffer to copy the blob to, or NULL to discard it
+ * @param    size_bytes      Size of the buffer at blob. Set to the size of
+ *                           the blob on return. May be NULL if blob is NULL.
+ *
+ * @return   ULIST_OK             If blob was removed successfully
+ * @return   ULIST_INVALID_PARAM  If the buffer is too small for the blob; the
+ *                                blob is not removed, and size_bytes is set to
+ *                                the size needed
+ */
+ulist_status_e ulist_blob_pop(ulist_blob_t *list, unsigned long long index,
+    void *blob, size_t *size_bytes);
+
+
+#endif
@@ -0,0 +1,520 @@
+/**
+ * @file   ulist_fine.c
+ * @author Erik Nyquist
+ * @brief  Concurrent ulist with per-node locking
+ */
+#include <string.h>
+#include <sched.h>
+#include "ulist_fine_api.h"
+#include "ulist_internal.h"
+
+
+#define NODE_UNLOCKED (0u)
+#define NODE_LOCKED (1u)
+
+
+// Nodes locked for access to a single item, in list order
+typedef struct {
+    ulist_node_t *previous;  // Locked, unless node is the head
+    ulist_node_t *node;      // Locked
+    size_t local_index;
+} locked_params_t;
+
+
+static void _node_lock(ulist_node_t *node)
+{
+    while (__atomic_exchange_n(&node->lock, NODE_LOCKED, __ATOMIC_ACQUIRE))
+    {
+        while (NODE_LOCKED == __atomic_load_n(&node->lock, __ATOMIC_RELAXED))
+        {
+            sched_yield();
+        }
+    }
+}
+
+
+static int _node_trylock(ulist_node_t *node)
+{
+    return !__atomic_exchange_n(&node->lock, NODE_LOCKED, __ATOMIC_ACQUIRE);
+}
+
+
+static void _node_unlock(ulist_node_t *node)
+{
+    __atomic_store_n(&node->lock, NODE_UNLOCKED, __ATOMIC_RELEASE);
+}
+
+
+static void _unlock_params(locked_params_t *params)
+{
+    if (NULL != params->previous)
+    {
+        _node_unlock(params->previous);
+    }
+
+    _node_unlock(params->node);
+}
+
+
+/* Allocate a new node, which is returned locked so that it can be connected
+ * to the list before it has been filled */
+static ulist_node_t *_alloc_locked_node(ulist_fine_t *fine)
+{
+    ulist_node_t *node;
+
+    if ((node = _alloc_node(&fine->list)) == NULL)
+    {
+        return NULL;
+    }
+
+    node->lock = NODE_LOCKED;
+    __atomic_add_fetch(&fine->list.nodes, 1u, __ATOMIC_RELAXED);
+    return node;
+}
+
+
+static void _set_tail(ulist_fine_t *fine, ulist_node_t *node)
+{
+    pthread_mutex_lock(&fine->tail_lock);
+    fine->list.tail = node;
+    pthread_mutex_unlock(&fine->tail_lock);
+}
+
+
+/* Lock the tail node. Nodes are locked while the tail lock is held, which is
+ * the opposite order to threads which change the tail, so we only try to lock
+ * the node and start over if it is busy. Changing the tail requires holding
+ * the lock on the current tail node, so once it is locked it can't change. */
+static ulist_node_t *_lock_tail(ulist_fine_t *fine)
+{
+    while (1)
+    {
+        pthread_mutex_lock(&fine->tail_lock);
+        ulist_node_t *tail = fine->list.tail;
+        int locked = _node_trylock(tail);
+        pthread_mutex_unlock(&fine->tail_lock);
+
+        if (locked)
+        {
+            return tail;
+        }
+
+        sched_yield();
+    }
+}
+
+
+/* Find an item by crawling from the head node with hand-over-hand locking.
+ * On success, the target node and the node before it are left locked. If
+ * allow_end is set, then an index one past the last item is accepted, and
+ * resolves to the end of the tail node. */
+static ulist_status_e _locked_crawl(ulist_fine_t *fine, unsigned long long index,
+    unsigned allow_end, locked_params_t *params)
+{
+    ulist_node_t *previous = NULL;
+    ulist_node_t *node = fine->list.head;
+    unsigned long long item_count = 0u;
+
+    _node_lock(node);
+
+    while ((item_count + node->used) <= index)
+    {
+        if (NULL == node->next)
+        {
+            if (allow_end && ((item_count + node->used) == index))
+            {
+                break;
+            }
+
+            if (NULL != previous)
+            {
+                _node_unlock(previous);
+            }
+
+            _node_unlock(node);
+            return ULIST_INDEX_OUT_OF_RANGE;
+        }
+
+        item_count += node->used;
+
+        // Take the next lock before letting go of the one behind us
+        ulist_node_t *next = node->next;
+        _node_lock(next);
+
+        if (NULL != previous)
+        {
+            _node_unlock(previous);
+        }
+
+        previous = node;
+        node = next;
+    }
+
+    params->previous = previous;
+    params->node = node;
+    params->local_index = index - item_count;
+    return ULIST_OK;
+}
+
+
+/* Connect a new node after a locked node. The node after the locked node (if
+ * any) also has to be locked while its previous pointer is changed. */
+static void _connect_after(ulist_fine_t *fine, ulist_node_t *node,
+    ulist_node_t *new)
+{
+    ulist_node_t *next = node->next;
+
+    new->previous = node;
+    new->next = next;
+
+    if (NULL == next)
+    {
+        node->next = new;
+        _set_tail(fine, new);
+    }
+    else
+    {
+        _node_lock(next);
+        next->previous = new;
+        node->next = new;
+        _node_unlock(next);
+    }
+}
+
+
+/* Free a locked empty node. The node before it must also be locked, so no
+ * crawler can be waiting for this node's lock. */
+static void _delete_locked_node(ulist_fine_t *fine, ulist_node_t *node)
+{
+    ulist_node_t *next = node->next;
+
+    if (NULL == next)
+    {
+        node->previous->next = NULL;
+        _set_tail(fine, node->previous);
+    }
+    else
+    {
+        _node_lock(next);
+        next->previous = node->previous;
+        node->previous->next = next;
+        _node_unlock(next);
+    }
+
+    _free_node(&fine->list, node);
+    __atomic_sub_fetch(&fine->list.nodes, 1u, __ATOMIC_RELAXED);
+}
+
+
+/* Add an item to a locked node that is full. Both nodes involved in the split
+ * (the full node, and the new node) are locked while the items are balanced,
+ * and the new node only becomes reachable once it has been connected. */
+static ulist_status_e _add_to_full_locked_node(ulist_fine_t *fine,
+    locked_params_t *params, void *item)
+{
+    ulist_node_t *new;
+
+    if ((new = _alloc_locked_node(fine)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    _connect_after(fine, params->node, new);
+    _balance_nodes(&fine->list, new, params->node, NOT_GREEDY);
+
+    access_params_t access = {.node=params->node,
+                              .local_index=params->local_index};
+
+    if (access.local_index > access.node->used)
+    {
+        // item must be inserted in new node
+        access.local_index -= access.node->used;
+        access.node = new;
+    }
+
+    _add_to_nonfull_node(&fine->list, &access, item);
+    _node_unlock(new);
+    return ULIST_OK;
+}
+
+
+/* Remove an item from a locked node. If the node is left half full or less,
+ * then it is merged with or balanced against a neighbour. Merging always
+ * combines into the earlier of the two nodes, so the head node never needs to
+ * be freed. */
+static void _remove_locked_item(ulist_fine_t *fine, locked_params_t *params)
+{
+    ulist_t *list = &fine->list;
+    ulist_node_t *node = params->node;
+
+    if (params->local_index != (node->used - 1u))
+    {
+        // Need to move some items into the freed space
+        size_t items_to_move = (node->used - 1u) - params->local_index;
+
+        memmove(
+            NODE_DATA(list, node, params->local_index),
+            NODE_DATA(list, node, params->local_index + 1u),
+            items_to_move * list->item_size_bytes);
+    }
+
+    node->used -= 1u;
+    __atomic_sub_fetch(&list->num_items, 1u, __ATOMIC_RELAXED);
+
+    if (node->used > (node->capacity / 2u))
+    {
+        // Node is over half full, nothing else to do
+        return;
+    }
+
+    if (NULL != node->next)
+    {
+        // Merge with, or take items from, the next node
+        ulist_node_t *next = node->next;
+        _node_lock(next);
+        _balance_nodes(list, node, next, GREEDY);
+
+        if (0u == next->used)
+        {
+            _delete_locked_node(fine, next);
+        }
+        else
+        {
+            _node_unlock(next);
+        }
+    }
+    else if (NULL != params->previous)
+    {
+        // Node is the tail, merge into or take items from the previous node
+        ulist_node_t *previous = params->previous;
+
+        if ((previous->used + node->used) <= previous->capacity)
+        {
+            _balance_nodes(list, previous, node, GREEDY);
+            _delete_locked_node(fine, node);
+            params->node = NULL;
+        }
+        else
+        {
+            _balance_nodes(list, node, previous, GREEDY);
+        }
+    }
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_create(ulist_fine_t *fine, size_t item_size_bytes,
+    size_t items_per_node)
+{
+    if (NULL == fine)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_create(&fine->list, item_size_bytes,
+                                      items_per_node);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    if (0 != pthread_mutex_init(&fine->tail_lock, NULL))
+    {
+        (void) ulist_destroy(&fine->list);
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_destroy(ulist_fine_t *fine)
+{
+    if (NULL == fine)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_destroy(&fine->list);
+    if (ULIST_OK == err)
+    {
+        pthread_mutex_destroy(&fine->tail_lock);
+    }
+
+    return err;
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_append_item(ulist_fine_t *fine, void *item)
+{
+    if ((NULL == fine) || (NULL == fine->list.head) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_node_t *tail = _lock_tail(fine);
+    access_params_t params = {.node=tail, .local_index=tail->used};
+
+    // Tail node is full, create new
+    if (tail->used == tail->capacity)
+    {
+        ulist_node_t *new;
+        if ((new = _alloc_locked_node(fine)) == NULL)
+        {
+            _node_unlock(tail);
+            return ULIST_ERROR_MEM;
+        }
+
+        _connect_after(fine, tail, new);
+        _node_unlock(tail);
+
+        params.node = new;
+        params.local_index = 0u;
+    }
+
+    _add_to_nonfull_node(&fine->list, &params, item);
+    __atomic_add_fetch(&fine->list.num_items, 1u, __ATOMIC_RELAXED);
+    _node_unlock(params.node);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_insert_item(ulist_fine_t *fine,
+    unsigned long long index, void *item)
+{
+    if ((NULL == fine) || (NULL == fine->list.head) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    locked_params_t params;
+    ulist_status_e err = _locked_crawl(fine, index, 1u, &params);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    ulist_node_t *previous = params.previous;
+    access_params_t access = {.node=params.node,
+                              .local_index=params.local_index};
+
+    // Add to the end of the previous node if possible, it's locked already
+    if ((0u == params.local_index) && (NULL != previous)
+         && (previous->used < previous->capacity))
+    {
+        access.node = previous;
+        access.local_index = previous->used;
+        _add_to_nonfull_node(&fine->list, &access, item);
+    }
+    // Current node is full, split it
+    else if (params.node->used == params.node->capacity)
+    {
+        if ((err = _add_to_full_locked_node(fine, &params, item)) != ULIST_OK)
+        {
+            _unlock_params(&params);
+            return err;
+        }
+    }
+    else
+    {
+        _add_to_nonfull_node(&fine->list, &access, item);
+    }
+
+    __atomic_add_fetch(&fine->list.num_items, 1u, __ATOMIC_RELAXED);
+    _unlock_params(&params);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_get_item(ulist_fine_t *fine, unsigned long long index,
+    void *item)
+{
+    if ((NULL == fine) || (NULL == fine->list.head) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    locked_params_t params;
+    ulist_status_e err = _locked_crawl(fine, index, 0u, &params);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    memcpy(item, NODE_DATA((&fine->list), params.node, params.local_index),
+           fine->list.item_size_bytes);
+
+    _unlock_params(&params);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_pop_item(ulist_fine_t *fine, unsigned long long index,
+    void *item)
+{
+    if ((NULL == fine) || (NULL == fine->list.head))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    locked_params_t params;
+    ulist_status_e err = _locked_crawl(fine, index, 0u, &params);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    if (NULL != item)
+    {
+        memcpy(item, NODE_DATA((&fine->list), params.node, params.local_index),
+               fine->list.item_size_bytes);
+    }
+
+    _remove_locked_item(fine, &params);
+
+    if (NULL != params.previous)
+    {
+        _node_unlock(params.previous);
+    }
+
+    // Node may have been merged into the previous node and freed
+    if (NULL != params.node)
+    {
+        _node_unlock(params.node);
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_fine_api.h
+ */
+ulist_status_e ulist_fine_num_items(ulist_fine_t *fine,
+    unsigned long long *num_items)
+{
+    if ((NULL == fine) || (NULL == num_items))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    *num_items = __atomic_load_n(&fine->list.num_items, __ATOMIC_RELAXED);
+    return ULIST_OK;
+}
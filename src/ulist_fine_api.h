@@ -0,0 +1,109 @@
+/**
+ * @file   ulist_fine_api.h
+ * @author Erik Nyquist
+ * @brief  Concurrent ulist with per-node locking
+ *
+ * Each node in the list carries its own lock, and operations find their
+ * target node by crawling from the head node with hand-over-hand locking
+ * (the lock on the next node is taken before the lock on the node before the
+ * current one is released). Threads working on different parts of the same
+ * list only contend for the nodes they are passing through, rather than
+ * serializing on a single list-wide lock.
+ *
+ * Since all crawls go from head to tail, locks are always taken in list order.
+ * The head node is never freed, and a node is only freed while its neighbours
+ * on both sides are locked, so a crawler can never be waiting on the lock of a
+ * node that is about to be freed. Appends go straight to the tail node rather
+ * than crawling.
+ *
+ * Indices are resolved against the list as the crawl passes over it, so if
+ * other threads are adding or removing items in front of the target at the
+ * same time, the index is relative to the list as it was when each node was
+ * passed.
+ */
+#ifndef ULIST_FINE_API_H
+#define ULIST_FINE_API_H
+
+#include <pthread.h>
+#include "ulist_api.h"
+
+
+/* Single concurrent ulist instance with per-node locking */
+typedef struct {
+    ulist_t list;
+    pthread_mutex_t tail_lock;  // Protects list.tail
+} ulist_fine_t;
+
+
+/**
+ * Initialize a concurrent list instance.
+ *
+ * @param    fine            Uninitialized list structure to initialize
+ * @param    item_size_bytes Size of a single list item in bytes
+ * @Param    items_per_node  Number of items that each list node should hold
+ *
+ * @return   ULIST_OK        If list instance was initialized successfully
+ */
+ulist_status_e ulist_fine_create(ulist_fine_t *fine, size_t item_size_bytes,
+    size_t items_per_node);
+
+
+/**
+ * Destroy an initialized concurrent list instance. No other threads may be
+ * accessing the list when this is called.
+ *
+ * @param    fine            List instance to destroy
+ *
+ * @return   ULIST_OK        If list instance was destroyed successfully
+ */
+ulist_status_e ulist_fine_destroy(ulist_fine_t *fine);
+
+
+/**
+ * Add an item to the end of a list. Only the tail node is locked.
+ *
+ * @see #ulist_append_item
+ */
+ulist_status_e ulist_fine_append_item(ulist_fine_t *fine, void *item);
+
+
+/**
+ * Insert an item at a specific index in a list.
+ *
+ * @see #ulist_insert_item
+ */
+ulist_status_e ulist_fine_insert_item(ulist_fine_t *fine,
+    unsigned long long index, void *item);
+
+
+/**
+ * Fetch an item from a specific index in a list.
+ *
+ * @see #ulist_get_item
+ */
+ulist_status_e ulist_fine_get_item(ulist_fine_t *fine, unsigned long long index,
+    void *item);
+
+
+/**
+ * Fetch and remove an item from a specific index in a list.
+ *
+ * @see #ulist_pop_item
+ */
+ulist_status_e ulist_fine_pop_item(ulist_fine_t *fine, unsigned long long index,
+    void *item);
+
+
+/**
+ * Query the number of items in a list.
+ *
+ * @param    fine            List instance
+ * @param    num_items       Pointer to write number of items to
+ *
+ * @return   ULIST_OK        If the number of items was fetched successfully
+ */
+ulist_status_e ulist_fine_num_items(ulist_fine_t *fine,
+    unsigned long long *num_items);
+
+
+#endif
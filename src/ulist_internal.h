@@ -0,0 +1,155 @@
+/**
+ * @file   ulist_internal.h
+ * @author Erik Nyquist
+ * @brief  Node handling shared between the ulist implementation files. Not
+ *         part of the public API.
+ */
+#ifndef ULIST_INTERNAL_H
+#define ULIST_INTERNAL_H
+
+#include <pthread.h>
+#include "ulist_api.h"
+
+#define MIN_ITEMS_PER_NODE (2u)
+
+#define GREEDY (1u)
+#define NOT_GREEDY (0u)
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+
+// Round n up to a multiple of align, which must be a power of 2
+#define ROUND_UP(n, align) (((n) + (align) - 1u) & ~((align) - 1u))
+
+// Nodes at least this large are marked for transparent huge pages
+#define HUGE_PAGE_BYTES (2u * 1024u * 1024u)
+
+#define NODE_ALLOC_SIZE(list) NODE_CAPACITY_SIZE(list, list->items_per_node)
+
+#define NODE_CAPACITY_SIZE(list, capacity) (sizeof(ulist_node_t) +   \
+                                            (list->item_size_bytes * \
+                                            (capacity)))
+
+#define NODE_DATA(list, node, i) (node->items + (list->item_size_bytes * (i)))
+
+/* Make sure the items of a node are in memory before they are accessed, and
+ * set dirty if a pointer to them is handed out. Evaluates to 0 if the items of
+ * a spilled node could not be loaded. */
+#define NODE_RESIDENT(list, node, dirty) ((NULL == (list)->spill) \
+    || _spill_use((list), (node), (dirty)))
+
+/* Add to one of the operation counters of a list; compiles to nothing unless
+ * ULIST_STATS is defined */
+#ifdef ULIST_STATS
+#define STATS_ADD(list, field, n) \
+    ((void) __atomic_add_fetch(&(list)->stats.field, (n), __ATOMIC_RELAXED))
+#else
+#define STATS_ADD(list, field, n) ((void) 0)
+#endif
+
+// Size of the header at the start of a saved list
+#define SAVED_HEADER_BYTES (64u)
+
+// Item in a list created with ulist_map
+#define MAPPED_ITEM(list, i) ((list)->mapping + SAVED_HEADER_BYTES + \
+                              ((list)->item_size_bytes * (i)))
+
+
+// Struct to hold parameters required to access a single data item in list
+typedef struct {
+    ulist_node_t *node;
+    size_t local_index;
+} access_params_t;
+
+
+/* Allocate and initialize a new node, without counting it in list->nodes.
+ * Returns NULL if allocation fails. */
+ulist_node_t *_alloc_node(ulist_t *list);
+
+/* Same as _alloc_node, for a node with room for capacity items instead of
+ * list->items_per_node */
+ulist_node_t *_alloc_sized_node(ulist_t *list, size_t capacity);
+
+/* Drop the list's reference to a node that is no longer connected to the
+ * list, without counting it in list->nodes. The node is freed once no
+ * snapshots hold it either. */
+void _free_node(ulist_t *list, ulist_node_t *node);
+
+/* Make sure a node in the list is not shared with any snapshots or clones
+ * before it is modified. If it is shared, it is replaced in the list with a
+ * private copy, which is returned. Returns NULL if allocation fails. */
+ulist_node_t *_own_node(ulist_t *list, ulist_node_t *node);
+
+/* Release one reference to a node, freeing it if it was the last one */
+void _release_node(ulist_node_t *node);
+
+/* Move items from src to dest until the number of items in dest has reached
+ * more than half. dest and src are expected to be connected. */
+void _balance_nodes(ulist_t *list, ulist_node_t *dest, ulist_node_t *src,
+    unsigned greedy);
+
+// Add item to a node that has space remaining -- no node allocation required
+void _add_to_nonfull_node(ulist_t *list, access_params_t *params, void *item);
+
+
+/* Bring a node's items into memory for a list created with
+ * ulist_spill_create, and mark it as most recently used. If dirty is set, the
+ * items are written back to the file if the node is evicted again. Returns 0
+ * if the items could not be loaded. */
+int _spill_use(ulist_t *list, ulist_node_t *node, int dirty);
+
+// Allocate a node for a list created with ulist_spill_create
+ulist_node_t *_spill_alloc_node(ulist_t *list);
+
+// Free a node of a list created with ulist_spill_create
+void _spill_free_node(ulist_t *list, ulist_node_t *node);
+
+// Free the spill state of a list, after all its nodes have been freed
+void _spill_destroy(ulist_t *list);
+
+
+// Operations recorded in the log of a list opened with ulist_wal_open
+typedef enum {
+    WAL_OP_APPEND = 1,
+    WAL_OP_INSERT,
+    WAL_OP_POP,
+    WAL_OP_CLEAR
+} wal_op_e;
+
+/* Run an append, insert, pop or clear on a list opened with ulist_wal_open with
+ * logging turned off, and add a record of it to the log if it succeeds */
+ulist_status_e _wal_apply(ulist_t *list, wal_op_e op, unsigned long long index,
+    void *item);
+
+// Write out buffered log records and free the log state of a list
+ulist_status_e _wal_close(ulist_t *list);
+
+
+// Free all spare nodes of a list
+void _free_spare_nodes(ulist_t *list);
+
+
+// Operations counted by lists with adaptive node capacity
+typedef enum {
+    ADAPT_OP_APPEND,
+    ADAPT_OP_INSERT,
+    ADAPT_OP_POP,
+    ADAPT_OP_GET
+} adapt_op_e;
+
+/* Count an operation on a list with adaptive node capacity, before it runs,
+ * and rebuild the list with a different node capacity if it is time to and
+ * it pays off */
+void _adapt_record(ulist_t *list, adapt_op_e op, unsigned long long index);
+
+
+/* Acquire the read lock of a list created with ulist_rw_create. Unless NDEBUG
+ * is defined, fails with EDEADLK if this thread already holds it, instead of
+ * deadlocking once a writer is waiting */
+int _rw_read_lock(pthread_rwlock_t *lock);
+
+// Release a read lock acquired with _rw_read_lock
+void _rw_read_unlock(pthread_rwlock_t *lock);
+
+
+#endif
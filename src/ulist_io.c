@@ -0,0 +1,265 @@
+/**
+ * @file   ulist_io.c
+ * @author Erik Nyquist
+ * @brief  Saving and loading whole ulist instances
+ */
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "ulist_io_api.h"
+#include "ulist_internal.h"
+
+
+_Static_assert(sizeof(ulist_io_header_t) == SAVED_HEADER_BYTES,
+               "Saved list header size doesn't match SAVED_HEADER_BYTES");
+
+
+// Number of nodes transferred with a single readv/writev call
+#define IO_BATCH_NODES (64u)
+
+
+/* Read or write all data described by iov, continuing after partial
+ * transfers. iov is modified. */
+static ulist_status_e _transfer(int fd, struct iovec *iov, int iovcnt,
+    int writing)
+{
+    while (iovcnt > 0)
+    {
+        ssize_t ret = (writing) ? writev(fd, iov, iovcnt)
+                                : readv(fd, iov, iovcnt);
+
+        if (ret < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            return ULIST_ERROR_IO;
+        }
+
+        if ((0 == ret) && !writing)
+        {
+            // End of file before all items were read
+            return ULIST_ERROR_FORMAT;
+        }
+
+        size_t done = (size_t) ret;
+
+        // Skip buffers that were transferred completely
+        while ((iovcnt > 0) && (done >= iov->iov_len))
+        {
+            done -= iov->iov_len;
+            iov += 1;
+            iovcnt -= 1;
+        }
+
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (char *) iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+
+    return ULIST_OK;
+}
+
+
+// Check that a header describes a list that can be created
+static int _valid_header(ulist_io_header_t *header)
+{
+    return (ULIST_IO_MAGIC == header->magic)
+           && (ULIST_IO_VERSION == header->version)
+           && (0u != header->item_size_bytes)
+           && (header->items_per_node >= MIN_ITEMS_PER_NODE)
+           && (header->items_per_node <= (SIZE_MAX / header->item_size_bytes));
+}
+
+
+/**
+ * @see ulist_io_api.h
+ */
+ulist_status_e ulist_save(ulist_t *list, int fd)
+{
+    if ((NULL == list) || (NULL == list->tail) || (NULL != list->spill)
+        || (fd < 0))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_io_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = ULIST_IO_MAGIC;
+    header.version = ULIST_IO_VERSION;
+    header.item_size_bytes = list->item_size_bytes;
+    header.items_per_node = list->items_per_node;
+    header.num_items = list->num_items;
+
+    struct iovec iov[IO_BATCH_NODES + 1u];
+    int iovcnt = 1;
+
+    // Header goes out with the first batch of nodes
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+
+    for (ulist_node_t *node = list->head; NULL != node; node = node->next)
+    {
+        if (0u == node->used)
+        {
+            continue;
+        }
+
+        iov[iovcnt].iov_base = node->items;
+        iov[iovcnt].iov_len = node->used * list->item_size_bytes;
+        iovcnt += 1;
+
+        if (iovcnt == (int) (IO_BATCH_NODES + 1u))
+        {
+            ulist_status_e err = _transfer(fd, iov, iovcnt, 1);
+            if (ULIST_OK != err)
+            {
+                return err;
+            }
+
+            iovcnt = 0;
+        }
+    }
+
+    return _transfer(fd, iov, iovcnt, 1);
+}
+
+
+/**
+ * @see ulist_io_api.h
+ */
+ulist_status_e ulist_load(ulist_t *list, int fd)
+{
+    if ((NULL == list) || (fd < 0))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_io_header_t header;
+    struct iovec iov[IO_BATCH_NODES];
+
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+
+    ulist_status_e err = _transfer(fd, iov, 1, 0);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    if (!_valid_header(&header))
+    {
+        return ULIST_ERROR_FORMAT;
+    }
+
+    if ((err = ulist_create(list, header.item_size_bytes,
+                            header.items_per_node)) != ULIST_OK)
+    {
+        return err;
+    }
+
+    unsigned long long remaining = header.num_items;
+    ulist_node_t *node = list->head;
+
+    while (remaining > 0u)
+    {
+        int iovcnt = 0;
+
+        // Fill a batch of nodes completely, except possibly the last one
+        while ((remaining > 0u) && (iovcnt < (int) IO_BATCH_NODES))
+        {
+            if (NULL == node)
+            {
+                if ((node = _alloc_node(list)) == NULL)
+                {
+                    (void) ulist_destroy(list);
+                    return ULIST_ERROR_MEM;
+                }
+
+                node->previous = list->tail;
+                list->tail->next = node;
+                list->tail = node;
+                list->nodes += 1u;
+            }
+
+            node->used = MIN(remaining, list->items_per_node);
+            remaining -= node->used;
+            list->num_items += node->used;
+
+            iov[iovcnt].iov_base = node->items;
+            iov[iovcnt].iov_len = node->used * list->item_size_bytes;
+            iovcnt += 1;
+            node = NULL;
+        }
+
+        if ((err = _transfer(fd, iov, iovcnt, 0)) != ULIST_OK)
+        {
+            (void) ulist_destroy(list);
+            return err;
+        }
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_io_api.h
+ */
+ulist_status_e ulist_map(ulist_t *list, int fd)
+{
+    struct stat st;
+
+    if ((NULL == list) || (fd < 0))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (0 != fstat(fd, &st))
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    size_t size = (size_t) st.st_size;
+
+    if (size < sizeof(ulist_io_header_t))
+    {
+        return ULIST_ERROR_FORMAT;
+    }
+
+    char *mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == mapping)
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    ulist_io_header_t *header = (ulist_io_header_t *) mapping;
+    size_t max_items = (size - sizeof(ulist_io_header_t))
+                       / MAX(header->item_size_bytes, 1u);
+
+    if (!_valid_header(header) || (header->num_items > max_items))
+    {
+        munmap(mapping, size);
+        return ULIST_ERROR_FORMAT;
+    }
+
+    memset(list, 0, sizeof(ulist_t));
+    list->item_size_bytes = header->item_size_bytes;
+    list->items_per_node = header->items_per_node;
+    list->edge_items_per_node = header->items_per_node;
+    list->num_items = header->num_items;
+
+    // Items are laid out as full nodes, in fixed-size blocks
+    list->nodes = (header->num_items + header->items_per_node - 1u)
+                  / header->items_per_node;
+    list->mapping = mapping;
+    list->mapping_size_bytes = size;
+    return ULIST_OK;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file   ulist_io_api.h
+ * @author Erik Nyquist
+ * @brief  Saving and loading whole ulist instances
+ *
+ * A saved list is a fixed-size header, followed by all items in list order
+ * with no gaps. The item data of each node is written directly from the node
+ * with vectored writes, and loading reads the items directly into full nodes,
+ * so neither side copies items through an intermediate buffer. Items and
+ * header fields are stored in the byte order of the host that saved them.
+ *
+ * A saved list can also be mapped into memory with #ulist_map instead of being
+ * loaded. Since the items are packed, item i is at a fixed offset in the file,
+ * so nothing needs to be read or allocated up front, and pages of the file are
+ * only read in when items on them are accessed.
+ */
+#ifndef ULIST_IO_API_H
+#define ULIST_IO_API_H
+
+#include <stdint.h>
+#include "ulist_api.h"
+
+
+/* First bytes of a saved list: "ULST" */
+#define ULIST_IO_MAGIC (0x54534c55u)
+
+/* Format version written by ulist_save */
+#define ULIST_IO_VERSION (1u)
+
+
+/* Header at the start of a saved list */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t item_size_bytes;
+    uint64_t items_per_node;
+    uint64_t num_items;
+    uint8_t reserved[32];  // Zero; pads the header to 64 bytes
+} ulist_io_header_t;
+
+
+/**
+ * Write the contents of a list to a file descriptor, starting at the current
+ * file position.
+ *
+ * @param    list            List instance
+ * @param    fd              File descriptor to write to
+ *
+ * @return   ULIST_OK        If the list was written successfully
+ * @return   ULIST_ERROR_IO  If writing failed
+ */
+ulist_status_e ulist_save(ulist_t *list, int fd);
+
+
+/**
+ * Create a list from data written by #ulist_save, reading from the current
+ * file position. Nodes are filled completely, except for the tail node.
+ *
+ * @param    list                Uninitialized list structure to initialize
+ * @param    fd                  File descriptor to read from
+ *
+ * @return   ULIST_OK            If the list was loaded successfully
+ * @return   ULIST_ERROR_IO      If reading failed
+ * @return   ULIST_ERROR_FORMAT  If the data is not a saved list, or is
+ *                               truncated
+ */
+ulist_status_e ulist_load(ulist_t *list, int fd);
+
+
+/**
+ * Create a read-only list backed by a memory mapping of a file written by
+ * #ulist_save. The whole file is mapped, and must start with the saved list.
+ * #ulist_get_item, #ulist_get_item_pointer and the ulist_iter_* functions read
+ * items directly from the mapping. Functions that modify the list return
+ * ULIST_READ_ONLY, and the iteration functions that keep their state in the
+ * list (#ulist_get_next_item etc.) are not supported. #ulist_destroy unmaps
+ * the file; fd can be closed as soon as this returns.
+ *
+ * @param    list                Uninitialized list structure to initialize
+ * @param    fd                  File descriptor of the file to map
+ *
+ * @return   ULIST_OK            If the list was mapped successfully
+ * @return   ULIST_ERROR_IO      If the file could not be mapped
+ * @return   ULIST_ERROR_FORMAT  If the file is not a saved list, or is
+ *                               truncated
+ */
+ulist_status_e ulist_map(ulist_t *list, int fd);
+
+
+#endif
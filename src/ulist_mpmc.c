@@ -0,0 +1,370 @@
+/**
+ * @file   ulist_mpmc.c
+ * @author Erik Nyquist
+ * @brief  Lock-free multi-producer/multi-consumer queue built on ulist nodes
+ */
+#include <string.h>
+#include "ulist_mpmc_api.h"
+#include "ulist_internal.h"
+
+
+// Slot states
+#define SLOT_EMPTY (0u)  // Nothing written yet
+#define SLOT_READY (1u)  // Item has been written by a producer
+#define SLOT_TAKEN (2u)  // Claimed by a consumer
+
+/* Number of retired segments each thread collects before scanning the hazard
+ * pointers to see which can be freed */
+#define RETIRE_THRESHOLD(queue) (2u * (queue)->max_threads)
+
+#define ALIGN_UP(x, a) ((((x) + (a) - 1u) / (a)) * (a))
+
+/* Segment metadata stored at the start of the node data, before the item
+ * slots: the dequeue counter, then one state word per slot */
+#define SEG_DEQUEUE_INDEX(node) ((size_t *) (node)->data)
+#define SEG_STATE(node, i) (((unsigned int *) ((node)->data + sizeof(size_t))) + (i))
+#define SEG_META_SIZE(queue) ALIGN_UP(sizeof(size_t) +                         \
+                                      ((queue)->items_per_node *               \
+                                       sizeof(unsigned int)),                  \
+                                      sizeof(size_t))
+
+#define SEG_SLOT(queue, node, i) ((node)->data + SEG_META_SIZE(queue) +        \
+                                  ((queue)->item_size_bytes * (i)))
+
+#define SEG_ALLOC_SIZE(queue) (sizeof(ulist_node_t) + SEG_META_SIZE(queue) +   \
+                               ((queue)->item_size_bytes *                     \
+                                (queue)->items_per_node))
+
+
+// Allocate a new, empty segment
+static ulist_node_t *_alloc_segment(ulist_mpmc_t *queue)
+{
+    ulist_node_t *node;
+
+    if ((node = malloc(SEG_ALLOC_SIZE(queue))) == NULL)
+    {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(ulist_node_t) + SEG_META_SIZE(queue));
+    return node;
+}
+
+
+/* Publish a hazard pointer for the segment that *src points to, and return the
+ * segment once it has been confirmed that *src did not change in between */
+static ulist_node_t *_protect(ulist_mpmc_thread_t *thread, ulist_node_t **src)
+{
+    ulist_node_t *node = __atomic_load_n(src, __ATOMIC_ACQUIRE);
+
+    while (1)
+    {
+        __atomic_store_n(&thread->hazard, node, __ATOMIC_SEQ_CST);
+
+        ulist_node_t *check = __atomic_load_n(src, __ATOMIC_SEQ_CST);
+        if (check == node)
+        {
+            return node;
+        }
+
+        node = check;
+    }
+}
+
+
+static void _clear_hazard(ulist_mpmc_thread_t *thread)
+{
+    __atomic_store_n(&thread->hazard, NULL, __ATOMIC_RELEASE);
+}
+
+
+static int _is_hazard(ulist_mpmc_t *queue, ulist_node_t *node)
+{
+    for (unsigned int i = 0u; i < queue->max_threads; i++)
+    {
+        if (__atomic_load_n(&queue->threads[i].hazard, __ATOMIC_SEQ_CST) == node)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/* Add a segment that has been unlinked from the queue to this thread's
+ * retired list, and free any retired segments no longer in use */
+static void _retire(ulist_mpmc_t *queue, ulist_mpmc_thread_t *thread,
+    ulist_node_t *node)
+{
+    thread->retired[thread->num_retired++] = node;
+
+    if (thread->num_retired < RETIRE_THRESHOLD(queue))
+    {
+        return;
+    }
+
+    size_t kept = 0u;
+
+    for (size_t i = 0u; i < thread->num_retired; i++)
+    {
+        if (_is_hazard(queue, thread->retired[i]))
+        {
+            thread->retired[kept++] = thread->retired[i];
+        }
+        else
+        {
+            free(thread->retired[i]);
+        }
+    }
+
+    thread->num_retired = kept;
+}
+
+
+/**
+ * @see ulist_mpmc_api.h
+ */
+ulist_status_e ulist_mpmc_create(ulist_mpmc_t *queue, size_t item_size_bytes,
+    size_t items_per_node, unsigned int max_threads)
+{
+    if ((NULL == queue) || (0u == item_size_bytes) || (0u == max_threads))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (items_per_node < MIN_ITEMS_PER_NODE)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    memset(queue, 0, sizeof(ulist_mpmc_t));
+    queue->item_size_bytes = item_size_bytes;
+    queue->items_per_node = items_per_node;
+    queue->max_threads = max_threads;
+
+    size_t threads_size = sizeof(ulist_mpmc_thread_t) * max_threads;
+    if ((queue->threads = aligned_alloc(ULIST_CACHE_LINE_BYTES,
+                                        threads_size)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    memset(queue->threads, 0, threads_size);
+
+    /* A thread can't have more than the threshold, plus one segment for each
+     * hazard pointer, retired at once */
+    size_t retired_size = sizeof(ulist_node_t *) *
+                          (RETIRE_THRESHOLD(queue) + max_threads);
+
+    for (unsigned int i = 0u; i < max_threads; i++)
+    {
+        if ((queue->threads[i].retired = malloc(retired_size)) == NULL)
+        {
+            (void) ulist_mpmc_destroy(queue);
+            return ULIST_ERROR_MEM;
+        }
+    }
+
+    if ((queue->head = _alloc_segment(queue)) == NULL)
+    {
+        (void) ulist_mpmc_destroy(queue);
+        return ULIST_ERROR_MEM;
+    }
+
+    queue->tail = queue->head;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_mpmc_api.h
+ */
+ulist_status_e ulist_mpmc_destroy(ulist_mpmc_t *queue)
+{
+    if (NULL == queue)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (NULL == queue->threads)
+    {
+        return ULIST_ALREADY_DESTROYED;
+    }
+
+    ulist_node_t *node = queue->head;
+    while (NULL != node)
+    {
+        ulist_node_t *old = node;
+        node = node->next;
+        free(old);
+    }
+
+    for (unsigned int i = 0u; i < queue->max_threads; i++)
+    {
+        ulist_mpmc_thread_t *thread = &queue->threads[i];
+
+        if (NULL != thread->retired)
+        {
+            for (size_t j = 0u; j < thread->num_retired; j++)
+            {
+                free(thread->retired[j]);
+            }
+
+            free(thread->retired);
+        }
+    }
+
+    free(queue->threads);
+    queue->threads = NULL;
+    queue->head = NULL;
+    queue->tail = NULL;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_mpmc_api.h
+ */
+ulist_status_e ulist_mpmc_push(ulist_mpmc_t *queue, unsigned int thread_id,
+    void *item)
+{
+    if ((NULL == queue) || (NULL == queue->threads) || (NULL == item)
+        || (thread_id >= queue->max_threads))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_mpmc_thread_t *thread = &queue->threads[thread_id];
+
+    while (1)
+    {
+        ulist_node_t *tail = _protect(thread, &queue->tail);
+        ulist_node_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+        if (NULL != next)
+        {
+            // Tail is lagging behind, help move it along
+            __atomic_compare_exchange_n(&queue->tail, &tail, next, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        size_t index = __atomic_fetch_add(&tail->used, 1u, __ATOMIC_ACQ_REL);
+
+        if (index >= queue->items_per_node)
+        {
+            // Segment is full, connect a new one with the item already in it
+            ulist_node_t *new;
+
+            if ((new = _alloc_segment(queue)) == NULL)
+            {
+                _clear_hazard(thread);
+                return ULIST_ERROR_MEM;
+            }
+
+            memcpy(SEG_SLOT(queue, new, 0u), item, queue->item_size_bytes);
+            *SEG_STATE(new, 0u) = SLOT_READY;
+            new->used = 1u;
+            new->previous = tail;
+
+            ulist_node_t *expected = NULL;
+            if (__atomic_compare_exchange_n(&tail->next, &expected, new, 0,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            {
+                __atomic_compare_exchange_n(&queue->tail, &tail, new, 0,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+                _clear_hazard(thread);
+                return ULIST_OK;
+            }
+
+            // Another producer connected a segment first
+            free(new);
+            continue;
+        }
+
+        memcpy(SEG_SLOT(queue, tail, index), item, queue->item_size_bytes);
+
+        unsigned int state = SLOT_EMPTY;
+        if (__atomic_compare_exchange_n(SEG_STATE(tail, index), &state,
+                                        SLOT_READY, 0, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE))
+        {
+            _clear_hazard(thread);
+            return ULIST_OK;
+        }
+
+        // A consumer gave up on this slot before we got to it, try again
+    }
+}
+
+
+/**
+ * @see ulist_mpmc_api.h
+ */
+ulist_status_e ulist_mpmc_pop(ulist_mpmc_t *queue, unsigned int thread_id,
+    void *item)
+{
+    if ((NULL == queue) || (NULL == queue->threads) || (NULL == item)
+        || (thread_id >= queue->max_threads))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_mpmc_thread_t *thread = &queue->threads[thread_id];
+
+    while (1)
+    {
+        ulist_node_t *head = _protect(thread, &queue->head);
+        size_t *dequeue_index = SEG_DEQUEUE_INDEX(head);
+
+        if ((__atomic_load_n(dequeue_index, __ATOMIC_ACQUIRE) >=
+             __atomic_load_n(&head->used, __ATOMIC_ACQUIRE))
+            && (NULL == __atomic_load_n(&head->next, __ATOMIC_ACQUIRE)))
+        {
+            // Nothing left to claim
+            _clear_hazard(thread);
+            return ULIST_END;
+        }
+
+        size_t index = __atomic_fetch_add(dequeue_index, 1u, __ATOMIC_ACQ_REL);
+
+        if (index >= queue->items_per_node)
+        {
+            // Segment is drained, move on to the next one
+            ulist_node_t *next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+
+            if (NULL == next)
+            {
+                _clear_hazard(thread);
+                return ULIST_END;
+            }
+
+            // Make sure the tail isn't left pointing at a retired segment
+            ulist_node_t *tail = head;
+            __atomic_compare_exchange_n(&queue->tail, &tail, next, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+            if (__atomic_compare_exchange_n(&queue->head, &head, next, 0,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            {
+                _clear_hazard(thread);
+                _retire(queue, thread, head);
+            }
+
+            continue;
+        }
+
+        unsigned int state = __atomic_exchange_n(SEG_STATE(head, index),
+                                                 SLOT_TAKEN, __ATOMIC_ACQ_REL);
+
+        if (SLOT_READY == state)
+        {
+            memcpy(item, SEG_SLOT(queue, head, index), queue->item_size_bytes);
+            _clear_hazard(thread);
+            return ULIST_OK;
+        }
+
+        // Producer hasn't written this slot yet, it will pick another one
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file   ulist_mpmc_api.h
+ * @author Erik Nyquist
+ * @brief  Lock-free multi-producer/multi-consumer queue built on ulist nodes
+ *
+ * A FIFO queue for any number of producer and consumer threads. Nodes are used
+ * as fixed-size segments of item slots: producers claim a slot in the tail
+ * segment with an atomic fetch-and-add on the segment's enqueue counter
+ * (node->used), and consumers claim slots in the head segment with a separate
+ * dequeue counter. Each slot has a state word which the producer sets once the
+ * item has been written; a consumer that reaches a slot before its producer
+ * has finished marks it as taken, and the producer moves on to a new slot.
+ *
+ * Segments that have been drained are unlinked and retired, and are freed
+ * once no thread holds a hazard pointer to them. Every thread using the queue
+ * must pass a unique thread ID, from 0 up to the max_threads value passed to
+ * #ulist_mpmc_create, to each call.
+ */
+#ifndef ULIST_MPMC_API_H
+#define ULIST_MPMC_API_H
+
+#include "ulist_api.h"
+
+
+/* Per-thread hazard pointer and list of retired segments */
+typedef struct {
+    _Alignas(ULIST_CACHE_LINE_BYTES)
+    ulist_node_t *hazard;
+    ulist_node_t **retired;
+    size_t num_retired;
+} ulist_mpmc_thread_t;
+
+
+/* Single MPMC queue instance */
+typedef struct {
+    size_t item_size_bytes;
+    size_t items_per_node;
+    unsigned int max_threads;
+    ulist_mpmc_thread_t *threads;
+
+    _Alignas(ULIST_CACHE_LINE_BYTES)
+    ulist_node_t *head;
+
+    _Alignas(ULIST_CACHE_LINE_BYTES)
+    ulist_node_t *tail;
+} ulist_mpmc_t;
+
+
+/**
+ * Initialize a queue instance.
+ *
+ * @param    queue           Uninitialized queue structure to initialize
+ * @param    item_size_bytes Size of a single item in bytes
+ * @Param    items_per_node  Number of item slots in each segment
+ * @param    max_threads     Maximum number of threads that will use the queue
+ *
+ * @return   ULIST_OK        If queue instance was initialized successfully
+ */
+ulist_status_e ulist_mpmc_create(ulist_mpmc_t *queue, size_t item_size_bytes,
+    size_t items_per_node, unsigned int max_threads);
+
+
+/**
+ * Destroy an initialized queue instance. No threads may be using the queue
+ * when this is called.
+ *
+ * @param    queue           Queue instance to destroy
+ *
+ * @return   ULIST_OK        If queue instance was destroyed successfully
+ */
+ulist_status_e ulist_mpmc_destroy(ulist_mpmc_t *queue);
+
+
+/**
+ * Add an item to the end of the queue.
+ *
+ * @param    queue           Queue instance
+ * @param    thread_id       ID of the calling thread, less than max_threads
+ * @param    item            Pointer to item data to add
+ *
+ * @return   ULIST_OK        If item was added successfully
+ */
+ulist_status_e ulist_mpmc_push(ulist_mpmc_t *queue, unsigned int thread_id,
+    void *item);
+
+
+/**
+ * Remove the item at the front of the queue.
+ *
+ * @param    queue           Queue instance
+ * @param    thread_id       ID of the calling thread, less than max_threads
+ * @param    item            Pointer to copy item data to
+ *
+ * @return   ULIST_OK        If an item was removed successfully, or ULIST_END
+ *                           if the queue is empty
+ */
+ulist_status_e ulist_mpmc_pop(ulist_mpmc_t *queue, unsigned int thread_id,
+    void *item);
+
+
+#endif
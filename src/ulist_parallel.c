@@ -0,0 +1,323 @@
+/**
+ * @file   ulist_parallel.c
+ * @author Erik Nyquist
+ * @brief  Parallel iteration over ulist node ranges
+ */
+#include <stdlib.h>
+#include <pthread.h>
+#include "ulist_parallel_api.h"
+#include "ulist_internal.h"
+
+
+// Range of items handled by a single thread
+typedef struct range {
+    ulist_t *list;
+    ulist_node_t *node;               // Node holding the first item
+    size_t local_index;               // Index of the first item in node
+    unsigned long long begin;         // List index of the first item
+    unsigned long long end;           // List index after the last item
+    unsigned long long number;        // Range number
+    unsigned long long chunk_items;   // Chunk size, or 0 if not chunked
+    void (*visit)(struct range *range, const ulist_span_t *span);
+    ulist_span_fn_t fn;
+    ulist_accumulate_fn_t accumulate;
+    void *acc;                        // Private accumulator, for reductions
+    void *ctx;
+} range_t;
+
+
+/* Split the list into nranges ranges of items. In chunked mode, ranges are
+ * made of whole chunks. The start of each range is found with a single walk
+ * over the node chain. */
+static void _partition(ulist_t *list, range_t *ranges, unsigned int nranges,
+    unsigned long long chunk_items)
+{
+    unsigned long long units = list->num_items;
+
+    if (0u != chunk_items)
+    {
+        units = (list->num_items + chunk_items - 1u) / chunk_items;
+    }
+
+    for (unsigned int i = 0u; i < nranges; i++)
+    {
+        unsigned long long first = (units * i) / nranges;
+        unsigned long long last = (units * (i + 1u)) / nranges;
+
+        if (0u != chunk_items)
+        {
+            first *= chunk_items;
+            last = MIN(last * chunk_items, list->num_items);
+        }
+
+        ranges[i].list = list;
+        ranges[i].begin = first;
+        ranges[i].end = last;
+        ranges[i].number = i;
+        ranges[i].chunk_items = chunk_items;
+    }
+
+    ulist_node_t *node = list->head;
+    unsigned long long node_start = 0u;
+
+    for (unsigned int i = 0u; i < nranges; i++)
+    {
+        // Find the node containing the first item of this range
+        while ((NULL != node->next) && ((node_start + node->used) <= ranges[i].begin))
+        {
+            node_start += node->used;
+            node = node->next;
+        }
+
+        ranges[i].node = node;
+        ranges[i].local_index = ranges[i].begin - node_start;
+    }
+}
+
+
+/* Visit each span in a range. Spans end at node boundaries, and also at
+ * chunk boundaries in chunked mode. */
+static void _walk_spans(range_t *range)
+{
+    ulist_t *list = range->list;
+    ulist_node_t *node = range->node;
+    size_t local_index = range->local_index;
+    unsigned long long index = range->begin;
+
+    while (index < range->end)
+    {
+        if (local_index == node->used)
+        {
+            node = node->next;
+            local_index = 0u;
+            continue;
+        }
+
+        ulist_span_t span;
+        unsigned long long span_end = MIN(range->end,
+                                          index + (node->used - local_index));
+
+        if (0u != range->chunk_items)
+        {
+            span.chunk = index / range->chunk_items;
+            span_end = MIN(span_end, (span.chunk + 1u) * range->chunk_items);
+        }
+        else
+        {
+            span.chunk = range->number;
+        }
+
+        span.items = NODE_DATA(list, node, local_index);
+        span.count = span_end - index;
+        span.index = index;
+        range->visit(range, &span);
+
+        local_index += span.count;
+        index = span_end;
+    }
+}
+
+
+static void _visit_for_each(range_t *range, const ulist_span_t *span)
+{
+    range->fn(span, range->ctx);
+}
+
+
+static void _visit_reduce(range_t *range, const ulist_span_t *span)
+{
+    range->accumulate(range->acc, span, range->ctx);
+}
+
+
+static void *_worker(void *arg)
+{
+    _walk_spans((range_t *) arg);
+    return NULL;
+}
+
+
+/* Number of ranges to split a list into for a parallel operation, given the
+ * number of threads requested */
+static unsigned int _num_ranges(ulist_t *list, unsigned int nthreads)
+{
+    unsigned long long nranges = list->num_items
+                                 / ULIST_PARALLEL_MIN_RANGE_ITEMS;
+
+    nranges = MIN(nranges, MIN(nthreads, ULIST_PARALLEL_MAX_THREADS));
+    return (unsigned int) MAX(nranges, 1u);
+}
+
+
+/* Partition the list and run each range on its own thread */
+static ulist_status_e _parallel_run(ulist_t *list, range_t *ranges,
+    unsigned int nranges, unsigned long long chunk_items)
+{
+    pthread_t threads[ULIST_PARALLEL_MAX_THREADS];
+    unsigned int started = 0u;
+
+    _partition(list, ranges, nranges, chunk_items);
+
+    // Calling thread takes the first range
+    for (unsigned int i = 1u; i < nranges; i++)
+    {
+        if (0 != pthread_create(&threads[i], NULL, _worker, &ranges[i]))
+        {
+            break;
+        }
+
+        started = i;
+    }
+
+    _walk_spans(&ranges[0]);
+
+    // Any ranges that didn't get a thread are run here
+    for (unsigned int i = started + 1u; i < nranges; i++)
+    {
+        _walk_spans(&ranges[i]);
+    }
+
+    for (unsigned int i = 1u; i <= started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    return ULIST_OK;
+}
+
+
+static ulist_status_e _for_each(ulist_t *list, ulist_span_fn_t fn, void *ctx,
+    unsigned int nthreads, unsigned long long chunk_items)
+{
+    if ((NULL == list) || (NULL == list->tail)
+        || (NULL != list->spill) || (NULL == fn)
+        || (0u == nthreads))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (0u == list->num_items)
+    {
+        return ULIST_OK;
+    }
+
+    // Callbacks may write to items, so nodes shared with a clone or snapshot
+    // are copied before any threads are started
+    for (ulist_node_t *node = list->head; NULL != node; node = node->next)
+    {
+        if ((node = _own_node(list, node)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+    }
+
+    unsigned int nranges = _num_ranges(list, nthreads);
+    range_t *ranges;
+
+    if ((ranges = malloc(sizeof(range_t) * nranges)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    for (unsigned int i = 0u; i < nranges; i++)
+    {
+        ranges[i].visit = _visit_for_each;
+        ranges[i].fn = fn;
+        ranges[i].ctx = ctx;
+    }
+
+    ulist_status_e err = _parallel_run(list, ranges, nranges, chunk_items);
+    free(ranges);
+    return err;
+}
+
+
+/**
+ * @see ulist_parallel_api.h
+ */
+ulist_status_e ulist_parallel_for_each(ulist_t *list, ulist_span_fn_t fn,
+    void *ctx, unsigned int nthreads)
+{
+    return _for_each(list, fn, ctx, nthreads, 0u);
+}
+
+
+/**
+ * @see ulist_parallel_api.h
+ */
+ulist_status_e ulist_parallel_for_each_chunked(ulist_t *list,
+    ulist_span_fn_t fn, void *ctx, unsigned int nthreads,
+    unsigned long long chunk_items)
+{
+    if (0u == chunk_items)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    return _for_each(list, fn, ctx, nthreads, chunk_items);
+}
+
+
+/**
+ * @see ulist_parallel_api.h
+ */
+ulist_status_e ulist_parallel_reduce(ulist_t *list, ulist_init_fn_t init,
+    ulist_accumulate_fn_t accumulate, ulist_combine_fn_t combine, void *ctx,
+    size_t acc_size_bytes, void *result, unsigned int nthreads)
+{
+    if ((NULL == list) || (NULL == list->tail)
+        || (NULL != list->spill) || (NULL == init)
+        || (NULL == accumulate) || (NULL == combine) || (NULL == result)
+        || (0u == acc_size_bytes) || (0u == nthreads))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    init(result, ctx);
+
+    if (0u == list->num_items)
+    {
+        return ULIST_OK;
+    }
+
+    unsigned int nranges = _num_ranges(list, nthreads);
+
+    // Each accumulator starts on its own cache line, so no two threads write
+    // to the same line while accumulating
+    size_t stride = ((acc_size_bytes + ULIST_CACHE_LINE_BYTES - 1u)
+                     / ULIST_CACHE_LINE_BYTES) * ULIST_CACHE_LINE_BYTES;
+    range_t *ranges;
+    char *accs;
+
+    if ((ranges = malloc(sizeof(range_t) * nranges)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    if ((accs = aligned_alloc(ULIST_CACHE_LINE_BYTES, stride * nranges)) == NULL)
+    {
+        free(ranges);
+        return ULIST_ERROR_MEM;
+    }
+
+    for (unsigned int i = 0u; i < nranges; i++)
+    {
+        ranges[i].visit = _visit_reduce;
+        ranges[i].accumulate = accumulate;
+        ranges[i].acc = accs + (stride * i);
+        ranges[i].ctx = ctx;
+        init(ranges[i].acc, ctx);
+    }
+
+    ulist_status_e err = _parallel_run(list, ranges, nranges, 0u);
+
+    // Combine in list order, so non-commutative reductions work too
+    for (unsigned int i = 0u; (ULIST_OK == err) && (i < nranges); i++)
+    {
+        combine(result, ranges[i].acc, ctx);
+    }
+
+    free(accs);
+    free(ranges);
+    return err;
+}
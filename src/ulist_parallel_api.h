@@ -0,0 +1,131 @@
+/**
+ * @file   ulist_parallel_api.h
+ * @author Erik Nyquist
+ * @brief  Parallel iteration over ulist node ranges
+ *
+ * The node chain is partitioned into one contiguous range of items per
+ * thread, and each thread passes its range to a callback as spans: runs of
+ * items that are contiguous in memory within a single node. The list must not
+ * be modified while a parallel operation is in progress.
+ *
+ * Threads are created for each call and joined before it returns. To keep
+ * that overhead small next to the work, every thread gets at least
+ * #ULIST_PARALLEL_MIN_RANGE_ITEMS items, so lists smaller than twice that are
+ * handled entirely by the calling thread, and no more than
+ * #ULIST_PARALLEL_MAX_THREADS threads are used.
+ */
+#ifndef ULIST_PARALLEL_API_H
+#define ULIST_PARALLEL_API_H
+
+#include "ulist_api.h"
+
+
+/* Maximum number of threads used by a parallel operation, including the
+ * calling thread */
+#define ULIST_PARALLEL_MAX_THREADS (64u)
+
+
+/* Smallest number of items handled by each thread of a parallel operation */
+#define ULIST_PARALLEL_MIN_RANGE_ITEMS (1024u)
+
+
+/* A run of items stored contiguously in a single node */
+typedef struct {
+    void *items;              // Pointer to the first item
+    size_t count;             // Number of items
+    unsigned long long index; // List index of the first item
+    unsigned long long chunk; // Chunk number in chunked mode, otherwise the
+                              // number of the range this span belongs to
+} ulist_span_t;
+
+
+/* Callback invoked for each span. Called concurrently from multiple threads,
+ * and may modify the items in the span */
+typedef void (*ulist_span_fn_t)(const ulist_span_t *span, void *ctx);
+
+
+/* Initializes an accumulator for #ulist_parallel_reduce */
+typedef void (*ulist_init_fn_t)(void *acc, void *ctx);
+
+
+/* Adds a span of items to an accumulator. Called concurrently from multiple
+ * threads, each with its own accumulator. The items in the span are shared
+ * with any clones or snapshots of the list, and must not be modified */
+typedef void (*ulist_accumulate_fn_t)(void *acc, const ulist_span_t *span,
+    void *ctx);
+
+
+/* Merges the accumulator "partial" into "acc". Called from a single thread */
+typedef void (*ulist_combine_fn_t)(void *acc, const void *partial, void *ctx);
+
+
+/**
+ * Invoke a callback on every item in a list, using multiple threads. The list
+ * is split into up to nthreads ranges holding (as near as possible) the same
+ * number of items, and each range is handled by a separate thread, with the
+ * calling thread handling the first range.
+ *
+ * @param    list            List instance
+ * @param    fn              Callback to invoke for each span of items
+ * @param    ctx             Context pointer passed to each callback
+ * @param    nthreads        Maximum number of threads to use, including the
+ *                           caller
+ *
+ * @return   ULIST_OK        If all items were visited successfully
+ * @return   ULIST_ERROR_MEM If a node shared with a clone or snapshot could
+ *                           not be copied
+ */
+ulist_status_e ulist_parallel_for_each(ulist_t *list, ulist_span_fn_t fn,
+    void *ctx, unsigned int nthreads);
+
+
+/**
+ * Same as #ulist_parallel_for_each, except that the list is divided into
+ * chunks of chunk_items items (the last chunk may be smaller), and spans never
+ * cross a chunk boundary. The chunk boundaries and the spans passed to the
+ * callback depend only on the list contents and chunk_items, and not on the
+ * number of threads, so combining per-chunk results in chunk order gives the
+ * same result for any number of threads.
+ *
+ * @param    list            List instance
+ * @param    fn              Callback to invoke for each span of items
+ * @param    ctx             Context pointer passed to each callback
+ * @param    nthreads        Maximum number of threads to use, including the
+ *                           caller
+ * @param    chunk_items     Number of items in each chunk
+ *
+ * @return   ULIST_OK        If all items were visited successfully
+ * @return   ULIST_ERROR_MEM If a node shared with a clone or snapshot could
+ *                           not be copied
+ */
+ulist_status_e ulist_parallel_for_each_chunked(ulist_t *list,
+    ulist_span_fn_t fn, void *ctx, unsigned int nthreads,
+    unsigned long long chunk_items);
+
+
+/**
+ * Reduce all items in a list to a single value, using multiple threads. The
+ * list is split into ranges in the same way as #ulist_parallel_for_each, and
+ * each thread accumulates its range into a private accumulator, initialized
+ * with init. Accumulators are placed on separate cache lines. Once all threads
+ * are done, the result is initialized with init, and the accumulators are
+ * merged into it with combine, in list order.
+ *
+ * @param    list            List instance
+ * @param    init            Accumulator initialization function
+ * @param    accumulate      Function to add a span of items to an accumulator
+ * @param    combine         Function to merge two accumulators
+ * @param    ctx             Context pointer passed to all callbacks
+ * @param    acc_size_bytes  Size of an accumulator in bytes
+ * @param    result          Pointer to acc_size_bytes bytes to write result to
+ * @param    nthreads        Maximum number of threads to use, including the
+ *                           caller
+ *
+ * @return   ULIST_OK        If the reduction was completed successfully
+ */
+ulist_status_e ulist_parallel_reduce(ulist_t *list, ulist_init_fn_t init,
+    ulist_accumulate_fn_t accumulate, ulist_combine_fn_t combine, void *ctx,
+    size_t acc_size_bytes, void *result, unsigned int nthreads);
+
+
+#endif
@@ -0,0 +1,822 @@
+/**
+ * @file   ulist_pv.c
+ * @author Erik Nyquist
+ * @brief  Persistent (immutable) versioned ulist
+ */
+#include <string.h>
+#include "ulist_pv_api.h"
+#include "ulist_internal.h"
+
+
+struct ulist_pv_index {
+    unsigned int refs;
+    unsigned int num_children;
+    unsigned long long counts[ULIST_PV_FANOUT];  // Items under each child
+    void *children[ULIST_PV_FANOUT];
+};
+
+typedef struct ulist_pv_index pv_index_t;
+
+
+// Modification applied by _edit
+typedef enum {
+    EDIT_INSERT,
+    EDIT_SET,
+    EDIT_REMOVE
+} edit_op_e;
+
+
+// Nodes replacing a node after an edit
+typedef struct {
+    void *nodes[2];
+    unsigned long long counts[2];
+    unsigned int num_nodes;        // 0 if the node is now empty, 2 if it split
+} edit_t;
+
+
+static ulist_node_t *_alloc_leaf(const ulist_pv_t *version)
+{
+    ulist_node_t *leaf;
+
+    if ((leaf = malloc(NODE_ALLOC_SIZE(version))) == NULL)
+    {
+        return NULL;
+    }
+
+    memset(leaf, 0, sizeof(ulist_node_t));
+    leaf->refs = 1u;
+    leaf->capacity = version->items_per_node;
+    leaf->items = leaf->data;
+    return leaf;
+}
+
+
+static pv_index_t *_alloc_index(void)
+{
+    pv_index_t *index;
+
+    if ((index = malloc(sizeof(pv_index_t))) == NULL)
+    {
+        return NULL;
+    }
+
+    index->refs = 1u;
+    index->num_children = 0u;
+    return index;
+}
+
+
+// Take a reference to a node at a specific height in the tree
+static void _retain(void *node, unsigned int height)
+{
+    unsigned int *refs = (0u == height) ? &((ulist_node_t *) node)->refs
+                                        : &((pv_index_t *) node)->refs;
+
+    __atomic_add_fetch(refs, 1u, __ATOMIC_RELAXED);
+}
+
+
+// Drop a reference to a node, freeing it and its subtree if it was the last
+static void _release(void *node, unsigned int height)
+{
+    if (0u == height)
+    {
+        _release_node((ulist_node_t *) node);
+        return;
+    }
+
+    pv_index_t *index = (pv_index_t *) node;
+
+    if ((1u == __atomic_load_n(&index->refs, __ATOMIC_ACQUIRE))
+        || (0u == __atomic_sub_fetch(&index->refs, 1u, __ATOMIC_ACQ_REL)))
+    {
+        for (unsigned int i = 0u; i < index->num_children; i++)
+        {
+            _release(index->children[i], height - 1u);
+        }
+
+        free(index);
+    }
+}
+
+
+/* Copy items [start, start + count) of a leaf, as it would be with item
+ * inserted at local_index, to dest */
+static void _copy_with_insert(const ulist_pv_t *version, ulist_node_t *leaf,
+    size_t local_index, const void *item, size_t start, size_t count,
+    char *dest)
+{
+    size_t size = version->item_size_bytes;
+    size_t end = start + count;
+
+    // Items before the inserted one
+    if (start < local_index)
+    {
+        size_t n = MIN(end, local_index) - start;
+        memcpy(dest, NODE_DATA(version, leaf, start), n * size);
+        dest += n * size;
+    }
+
+    if ((start <= local_index) && (local_index < end))
+    {
+        memcpy(dest, item, size);
+        dest += size;
+    }
+
+    // Items after the inserted one
+    size_t first = MAX(start, local_index + 1u);
+    if (first < end)
+    {
+        memcpy(dest, NODE_DATA(version, leaf, first - 1u), (end - first) * size);
+    }
+}
+
+
+static ulist_status_e _edit_leaf(const ulist_pv_t *version, ulist_node_t *leaf,
+    size_t local_index, edit_op_e op, void *item, edit_t *res)
+{
+    size_t size = version->item_size_bytes;
+    ulist_node_t *new;
+
+    if ((EDIT_REMOVE == op) && (1u == leaf->used))
+    {
+        // Leaf is now empty; parent drops it
+        res->num_nodes = 0u;
+        return ULIST_OK;
+    }
+
+    if ((new = _alloc_leaf(version)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    res->nodes[0] = new;
+    res->num_nodes = 1u;
+
+    if (EDIT_SET == op)
+    {
+        memcpy(new->items, leaf->items, leaf->used * size);
+        memcpy(NODE_DATA(version, new, local_index), item, size);
+        new->used = leaf->used;
+    }
+    else if (EDIT_REMOVE == op)
+    {
+        memcpy(new->items, leaf->items, local_index * size);
+        memcpy(NODE_DATA(version, new, local_index),
+               NODE_DATA(version, leaf, local_index + 1u),
+               (leaf->used - local_index - 1u) * size);
+        new->used = leaf->used - 1u;
+    }
+    else if (leaf->used < version->items_per_node)
+    {
+        _copy_with_insert(version, leaf, local_index, item, 0u,
+                          leaf->used + 1u, new->items);
+        new->used = leaf->used + 1u;
+    }
+    else
+    {
+        // Leaf is full, split it in two
+        ulist_node_t *right;
+
+        if ((right = _alloc_leaf(version)) == NULL)
+        {
+            _release_node(new);
+            return ULIST_ERROR_MEM;
+        }
+
+        new->used = (leaf->used + 1u) / 2u;
+        right->used = (leaf->used + 1u) - new->used;
+        _copy_with_insert(version, leaf, local_index, item, 0u, new->used,
+                          new->items);
+        _copy_with_insert(version, leaf, local_index, item, new->used,
+                          right->used, right->items);
+
+        res->nodes[1] = right;
+        res->num_nodes = 2u;
+    }
+
+    res->counts[0] = new->used;
+    res->counts[1] = (2u == res->num_nodes)
+                     ? ((ulist_node_t *) res->nodes[1])->used : 0u;
+    return ULIST_OK;
+}
+
+
+/* Merge an under-filled leaf at position i with a neighbour, if the items of
+ * both fit into a single leaf. Returns 1 if the leaves were merged. */
+static int _merge_leaves(const ulist_pv_t *version, void **children,
+    unsigned long long *counts, unsigned int *num_children, unsigned int i,
+    ulist_status_e *err)
+{
+    size_t half_items = version->items_per_node / 2u;
+
+    if ((counts[i] > half_items) || (*num_children < 2u))
+    {
+        return 0;
+    }
+
+    unsigned int left = (i + 1u < *num_children) ? i : i - 1u;
+
+    if ((counts[left] + counts[left + 1u]) > version->items_per_node)
+    {
+        return 0;
+    }
+
+    ulist_node_t *a = (ulist_node_t *) children[left];
+    ulist_node_t *b = (ulist_node_t *) children[left + 1u];
+    ulist_node_t *merged;
+
+    if ((merged = _alloc_leaf(version)) == NULL)
+    {
+        *err = ULIST_ERROR_MEM;
+        return 0;
+    }
+
+    memcpy(merged->items, a->items, a->used * version->item_size_bytes);
+    memcpy(NODE_DATA(version, merged, a->used), b->items,
+           b->used * version->item_size_bytes);
+    merged->used = a->used + b->used;
+
+    // Only the edited leaf is owned here; the neighbour was never retained
+    _release_node((ulist_node_t *) children[i]);
+
+    children[left] = merged;
+    counts[left] = merged->used;
+    *num_children -= 1u;
+    memmove(&children[left + 1u], &children[left + 2u],
+            (*num_children - (left + 1u)) * sizeof(void *));
+    memmove(&counts[left + 1u], &counts[left + 2u],
+            (*num_children - (left + 1u)) * sizeof(unsigned long long));
+    return 1;
+}
+
+
+/* Apply an edit to the subtree under node, returning the nodes that replace
+ * it. The subtree itself is never modified. */
+static ulist_status_e _edit(const ulist_pv_t *version, void *node,
+    unsigned int height, unsigned long long index, edit_op_e op, void *item,
+    edit_t *res)
+{
+    if (0u == height)
+    {
+        ulist_node_t *leaf = (ulist_node_t *) node;
+
+        if (EDIT_REMOVE == op)
+        {
+            if (NULL != item)
+            {
+                memcpy(item, NODE_DATA(version, leaf, index),
+                       version->item_size_bytes);
+            }
+        }
+
+        return _edit_leaf(version, leaf, (size_t) index, op, item, res);
+    }
+
+    pv_index_t *old = (pv_index_t *) node;
+    unsigned int i = 0u;
+
+    // Find the child holding the target; inserts may go at the end of one
+    while ((i < (old->num_children - 1u))
+           && ((index > old->counts[i])
+               || ((EDIT_INSERT != op) && (index == old->counts[i]))))
+    {
+        index -= old->counts[i];
+        i += 1u;
+    }
+
+    edit_t child;
+    ulist_status_e err = _edit(version, old->children[i], height - 1u, index,
+                               op, item, &child);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    // Children of the new node(s), with the edited child replaced
+    void *children[ULIST_PV_FANOUT + 1u];
+    unsigned long long counts[ULIST_PV_FANOUT + 1u];
+    unsigned int num_children = 0u;
+    unsigned int fresh = i;
+
+    for (unsigned int j = 0u; j < old->num_children; j++)
+    {
+        if (j != i)
+        {
+            children[num_children] = old->children[j];
+            counts[num_children] = old->counts[j];
+            num_children += 1u;
+            continue;
+        }
+
+        for (unsigned int k = 0u; k < child.num_nodes; k++)
+        {
+            children[num_children] = child.nodes[k];
+            counts[num_children] = child.counts[k];
+            num_children += 1u;
+        }
+    }
+
+    int merged = 0;
+
+    if ((1u == height) && (1u == child.num_nodes))
+    {
+        merged = _merge_leaves(version, children, counts, &num_children, i,
+                               &err);
+        if (ULIST_OK != err)
+        {
+            _release_node((ulist_node_t *) child.nodes[0]);
+            return err;
+        }
+
+        fresh = (merged && (i == num_children)) ? i - 1u : i;
+    }
+
+    if (0u == num_children)
+    {
+        res->num_nodes = 0u;
+        return ULIST_OK;
+    }
+
+    // Split if the edited child was split and this node was already full
+    res->num_nodes = (num_children > ULIST_PV_FANOUT) ? 2u : 1u;
+    unsigned int split = (2u == res->num_nodes) ? num_children / 2u
+                                                : num_children;
+
+    unsigned int num_fresh = merged ? 1u : child.num_nodes;
+
+    for (unsigned int n = 0u; n < res->num_nodes; n++)
+    {
+        pv_index_t *new;
+
+        if ((new = _alloc_index()) == NULL)
+        {
+            if (1u == n)
+            {
+                free(res->nodes[0]);
+            }
+
+            for (unsigned int j = fresh; j < (fresh + num_fresh); j++)
+            {
+                _release(children[j], height - 1u);
+            }
+
+            return ULIST_ERROR_MEM;
+        }
+
+        res->nodes[n] = new;
+        res->counts[n] = 0u;
+    }
+
+    for (unsigned int j = 0u; j < num_children; j++)
+    {
+        pv_index_t *new = (pv_index_t *) res->nodes[(j < split) ? 0u : 1u];
+
+        // Children shared with the old node need a reference of their own
+        if ((j < fresh) || (j >= (fresh + num_fresh)))
+        {
+            _retain(children[j], height - 1u);
+        }
+
+        new->children[new->num_children] = children[j];
+        new->counts[new->num_children] = counts[j];
+        new->num_children += 1u;
+        res->counts[(j < split) ? 0u : 1u] += counts[j];
+    }
+
+    return ULIST_OK;
+}
+
+
+// Replace the root of a version with the result of an edit on it
+static ulist_status_e _new_root(ulist_pv_t *version, edit_t *res)
+{
+    if (0u == res->num_nodes)
+    {
+        // List is now empty
+        if ((version->root = _alloc_leaf(version)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        version->height = 0u;
+        return ULIST_OK;
+    }
+
+    if (2u == res->num_nodes)
+    {
+        pv_index_t *root;
+
+        if ((version->height + 1u) > ULIST_PV_MAX_HEIGHT)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        if ((root = _alloc_index()) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        root->num_children = 2u;
+        root->children[0] = res->nodes[0];
+        root->children[1] = res->nodes[1];
+        root->counts[0] = res->counts[0];
+        root->counts[1] = res->counts[1];
+
+        version->root = root;
+        version->height += 1u;
+        return ULIST_OK;
+    }
+
+    version->root = res->nodes[0];
+
+    // Drop index levels that only have a single child
+    while (version->height > 0u)
+    {
+        pv_index_t *root = (pv_index_t *) version->root;
+
+        if (1u != root->num_children)
+        {
+            break;
+        }
+
+        version->root = root->children[0];
+        _retain(version->root, version->height - 1u);
+        _release(root, version->height);
+        version->height -= 1u;
+    }
+
+    return ULIST_OK;
+}
+
+
+static ulist_status_e _apply(ulist_pv_t *version, unsigned long long index,
+    edit_op_e op, void *item, ulist_pv_t *out)
+{
+    edit_t res;
+    ulist_pv_t new = *version;
+
+    ulist_status_e err = _edit(version, version->root, version->height, index,
+                               op, item, &res);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    if ((err = _new_root(&new, &res)) != ULIST_OK)
+    {
+        for (unsigned int n = 0u; n < res.num_nodes; n++)
+        {
+            _release(res.nodes[n], version->height);
+        }
+
+        return err;
+    }
+
+    new.num_items += (EDIT_INSERT == op) ? 1u : 0u;
+    new.num_items -= (EDIT_REMOVE == op) ? 1u : 0u;
+
+    if (out == version)
+    {
+        (void) ulist_pv_release(version);
+    }
+
+    *out = new;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_create(ulist_pv_t *version, size_t item_size_bytes,
+    size_t items_per_node)
+{
+    if ((NULL == version) || (0u == item_size_bytes)
+        || (items_per_node < MIN_ITEMS_PER_NODE))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    version->item_size_bytes = item_size_bytes;
+    version->items_per_node = items_per_node;
+    version->num_items = 0u;
+    version->height = 0u;
+
+    if ((version->root = _alloc_leaf(version)) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_from_list(ulist_t *list, ulist_pv_t *version)
+{
+    // Leaves all need the same capacity
+    if ((NULL == list) || (NULL == list->tail) || (NULL != list->spill)
+        || (NULL == version)
+        || (list->edge_items_per_node != list->items_per_node))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (0u == list->num_items)
+    {
+        return ulist_pv_create(version, list->item_size_bytes,
+                               list->items_per_node);
+    }
+
+    size_t num_nodes = (size_t) list->nodes;
+    void **level;
+    unsigned long long *counts;
+
+    if ((level = malloc(num_nodes * (sizeof(void *)
+                        + sizeof(unsigned long long)))) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    counts = (unsigned long long *) (level + num_nodes);
+    size_t n = 0u;
+
+    // List nodes become the leaves, and are copied by the list when modified
+    for (ulist_node_t *node = list->head; NULL != node; node = node->next)
+    {
+        _retain(node, 0u);
+        level[n] = node;
+        counts[n] = node->used;
+        n += 1u;
+    }
+
+    version->item_size_bytes = list->item_size_bytes;
+    version->items_per_node = list->items_per_node;
+    version->num_items = list->num_items;
+    version->height = 0u;
+
+    // Build index levels bottom-up, in place
+    while (n > 1u)
+    {
+        size_t parents = (n + ULIST_PV_FANOUT - 1u) / ULIST_PV_FANOUT;
+
+        for (size_t p = 0u; p < parents; p++)
+        {
+            pv_index_t *index;
+
+            if ((index = _alloc_index()) == NULL)
+            {
+                // Release what was built of this level, and the rest below
+                for (size_t j = 0u; j < p; j++)
+                {
+                    _release(level[j], version->height + 1u);
+                }
+
+                for (size_t j = p * ULIST_PV_FANOUT; j < n; j++)
+                {
+                    _release(level[j], version->height);
+                }
+
+                free(level);
+                return ULIST_ERROR_MEM;
+            }
+
+            unsigned long long total = 0u;
+            size_t first = p * ULIST_PV_FANOUT;
+
+            for (size_t j = first; (j < n) && (j < first + ULIST_PV_FANOUT); j++)
+            {
+                index->children[index->num_children] = level[j];
+                index->counts[index->num_children] = counts[j];
+                index->num_children += 1u;
+                total += counts[j];
+            }
+
+            level[p] = index;
+            counts[p] = total;
+        }
+
+        n = parents;
+        version->height += 1u;
+    }
+
+    version->root = level[0];
+    free(level);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_release(ulist_pv_t *version)
+{
+    if ((NULL == version) || (NULL == version->root))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    _release(version->root, version->height);
+    version->root = NULL;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_insert_item(ulist_pv_t *version,
+    unsigned long long index, void *item, ulist_pv_t *out)
+{
+    if ((NULL == version) || (NULL == version->root) || (NULL == item)
+        || (NULL == out))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index > version->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    return _apply(version, index, EDIT_INSERT, item, out);
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_append_item(ulist_pv_t *version, void *item,
+    ulist_pv_t *out)
+{
+    if (NULL == version)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    return ulist_pv_insert_item(version, version->num_items, item, out);
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_set_item(ulist_pv_t *version, unsigned long long index,
+    void *item, ulist_pv_t *out)
+{
+    if ((NULL == version) || (NULL == version->root) || (NULL == item)
+        || (NULL == out))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= version->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    return _apply(version, index, EDIT_SET, item, out);
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_pop_item(ulist_pv_t *version, unsigned long long index,
+    void *item, ulist_pv_t *out)
+{
+    if ((NULL == version) || (NULL == version->root) || (NULL == out))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= version->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    return _apply(version, index, EDIT_REMOVE, item, out);
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_get_item(const ulist_pv_t *version,
+    unsigned long long index, void *item)
+{
+    ulist_pv_iter_t iter;
+    void *data;
+
+    if (NULL == item)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_pv_iter_init(version, &iter, index);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    if ((err = ulist_pv_iter_next(&iter, &data)) != ULIST_OK)
+    {
+        return (ULIST_END == err) ? ULIST_INDEX_OUT_OF_RANGE : err;
+    }
+
+    memcpy(item, data, version->item_size_bytes);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_iter_init(const ulist_pv_t *version,
+    ulist_pv_iter_t *iter, unsigned long long index)
+{
+    if ((NULL == version) || (NULL == version->root) || (NULL == iter))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    // Index of 0 is allowed on an empty version; the iteration just ends
+    if ((index >= version->num_items) && (0u != index))
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    void *node = version->root;
+    iter->version = version;
+
+    for (unsigned int h = version->height; h > 0u; h--)
+    {
+        pv_index_t *parent = (pv_index_t *) node;
+        unsigned int i = 0u;
+
+        while ((i < (parent->num_children - 1u)) && (index >= parent->counts[i]))
+        {
+            index -= parent->counts[i];
+            i += 1u;
+        }
+
+        iter->path[h - 1u] = parent;
+        iter->pos[h - 1u] = i;
+        node = parent->children[i];
+    }
+
+    iter->leaf = (ulist_node_t *) node;
+    iter->local_index = (size_t) index;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_pv_api.h
+ */
+ulist_status_e ulist_pv_iter_next(ulist_pv_iter_t *iter, void **item)
+{
+    if ((NULL == iter) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    while (iter->local_index >= iter->leaf->used)
+    {
+        unsigned int h = 0u;
+
+        // Climb to the first level with a child to the right of the path
+        while ((h < iter->version->height)
+               && ((iter->pos[h] + 1u) >= iter->path[h]->num_children))
+        {
+            h += 1u;
+        }
+
+        if (h == iter->version->height)
+        {
+            return ULIST_END;
+        }
+
+        iter->pos[h] += 1u;
+        void *node = iter->path[h]->children[iter->pos[h]];
+
+        // Descend along the leftmost children to the next leaf
+        while (h > 0u)
+        {
+            h -= 1u;
+            iter->path[h] = (pv_index_t *) node;
+            iter->pos[h] = 0u;
+            node = iter->path[h]->children[0];
+        }
+
+        iter->leaf = (ulist_node_t *) node;
+        iter->local_index = 0u;
+    }
+
+    *item = NODE_DATA(iter->version, iter->leaf, iter->local_index);
+    iter->local_index += 1u;
+    return ULIST_OK;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file   ulist_pv_api.h
+ * @author Erik Nyquist
+ * @brief  Persistent (immutable) versioned ulist
+ *
+ * A persistent list is a series of immutable versions. Every modification
+ * leaves the version it was applied to unchanged, and returns a new version
+ * that shares all untouched nodes with the old one.
+ *
+ * Items are stored in ulist nodes as usual, but instead of being chained
+ * together the nodes are the leaves of a tree of index nodes, each holding up
+ * to #ULIST_PV_FANOUT children along with the number of items under each
+ * child. A modification copies only the leaf node it changes and the index
+ * nodes on the path from the root down to it, so keeping many versions costs
+ * memory in proportion to the number of edits rather than the size of the
+ * list. Nodes are reference counted, and freed when no version uses them.
+ *
+ * Versions are never modified once created, so any number of threads can read
+ * them and derive new versions from them at the same time.
+ */
+#ifndef ULIST_PV_API_H
+#define ULIST_PV_API_H
+
+#include "ulist_api.h"
+
+
+/* Maximum number of children of a single index node */
+#define ULIST_PV_FANOUT (16u)
+
+/* Maximum number of index node levels above the leaf nodes */
+#define ULIST_PV_MAX_HEIGHT (16u)
+
+
+/* Index node; private to ulist_pv.c */
+struct ulist_pv_index;
+
+
+/* Single version of a persistent list */
+typedef struct {
+    void *root;                       // Leaf node if height is 0, else index
+    unsigned int height;              // Levels of index nodes above leaves
+    unsigned long long num_items;
+    size_t item_size_bytes;
+    size_t items_per_node;
+} ulist_pv_t;
+
+
+/* Iteration state for reading items from a version in order */
+typedef struct {
+    const ulist_pv_t *version;
+    struct ulist_pv_index *path[ULIST_PV_MAX_HEIGHT]; // Index node per level
+    unsigned int pos[ULIST_PV_MAX_HEIGHT];            // Child taken per level
+    ulist_node_t *leaf;
+    size_t local_index;
+} ulist_pv_iter_t;
+
+
+/**
+ * Create an empty version.
+ *
+ * @param    version         Uninitialized version structure to initialize
+ * @param    item_size_bytes Size of a single list item in bytes
+ * @Param    items_per_node  Number of items that each leaf node should hold
+ *
+ * @return   ULIST_OK        If the version was created successfully
+ */
+ulist_status_e ulist_pv_create(ulist_pv_t *version, size_t item_size_bytes,
+    size_t items_per_node);
+
+
+/**
+ * Create a version holding the current contents of a regular list. The nodes
+ * of the list are shared with the new version, so only index nodes are
+ * allocated; the list copies any node it later modifies, in the same way as
+ * for snapshots. Nothing can be modifying the list while this runs.
+ *
+ * @param    list            List instance
+ * @param    version         Uninitialized version structure to initialize
+ *
+ * @return   ULIST_OK            If the version was created successfully
+ * @return   ULIST_INVALID_PARAM If list was created with ulist_create_tiered
+ */
+ulist_status_e ulist_pv_from_list(ulist_t *list, ulist_pv_t *version);
+
+
+/**
+ * Release a version. Nodes not used by any other version are freed.
+ *
+ * @param    version         Version to release
+ *
+ * @return   ULIST_OK        If the version was released successfully
+ */
+ulist_status_e ulist_pv_release(ulist_pv_t *version);
+
+
+/**
+ * Create a new version with an item inserted at a specific index.
+ *
+ * @param    version         Version to modify
+ * @param    index           List index to insert item at
+ * @param    item            Pointer to item data to insert
+ * @param    out             Uninitialized version structure for the result.
+ *                           May be the same as version, in which case the old
+ *                           version is released once the new one is created.
+ *
+ * @return   ULIST_OK        If the new version was created successfully
+ */
+ulist_status_e ulist_pv_insert_item(ulist_pv_t *version,
+    unsigned long long index, void *item, ulist_pv_t *out);
+
+
+/**
+ * Create a new version with an item added to the end.
+ *
+ * @see #ulist_pv_insert_item
+ */
+ulist_status_e ulist_pv_append_item(ulist_pv_t *version, void *item,
+    ulist_pv_t *out);
+
+
+/**
+ * Create a new version with the item at a specific index replaced.
+ *
+ * @see #ulist_pv_insert_item
+ */
+ulist_status_e ulist_pv_set_item(ulist_pv_t *version, unsigned long long index,
+    void *item, ulist_pv_t *out);
+
+
+/**
+ * Create a new version with the item at a specific index removed.
+ *
+ * @param    version         Version to modify
+ * @param    index           List index of item to remove
+ * @param    item            Pointer to location to copy removed item to. May
+ *                           be NULL.
+ * @param    out             Uninitialized version structure for the result.
+ *                           May be the same as version, in which case the old
+ *                           version is released once the new one is created.
+ *
+ * @return   ULIST_OK        If the new version was created successfully
+ */
+ulist_status_e ulist_pv_pop_item(ulist_pv_t *version, unsigned long long index,
+    void *item, ulist_pv_t *out);
+
+
+/**
+ * Fetch an item from a specific index in a version.
+ *
+ * @param    version         Version instance
+ * @param    index           List index of item to fetch
+ * @param    item            Pointer to location to copy item to
+ *
+ * @return   ULIST_OK        If the item was fetched successfully
+ */
+ulist_status_e ulist_pv_get_item(const ulist_pv_t *version,
+    unsigned long long index, void *item);
+
+
+/**
+ * Start iterating over a version from a specific index.
+ *
+ * @param    version         Version instance
+ * @param    iter            Iterator to initialize
+ * @param    index           List index of the first item to fetch
+ *
+ * @return   ULIST_OK        If the iterator was initialized successfully
+ */
+ulist_status_e ulist_pv_iter_init(const ulist_pv_t *version,
+    ulist_pv_iter_t *iter, unsigned long long index);
+
+
+/**
+ * Fetch a pointer to the next item in a version. The item must not be
+ * modified through the pointer.
+ *
+ * @param    iter            Iterator instance
+ * @param    item            Pointer to location to store item pointer
+ *
+ * @return   ULIST_OK        If the item was fetched successfully
+ * @return   ULIST_END       If there are no more items
+ */
+ulist_status_e ulist_pv_iter_next(ulist_pv_iter_t *iter, void **item);
+
+
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @file   ulist_rw.c
+ * @author Erik Nyquist
+ * @brief  Thread-safe ulist wrapper with reader-writer locking
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include "ulist_rw_api.h"
+#include "ulist_internal.h"
+
+
+// Run a write operation while holding the write lock
+#define WITH_WRITE_LOCK(rw, op) do {                                           \
+    if (0 != _write_lock(&(rw)->lock))                                         \
+    {                                                                          \
+        return ULIST_ERROR_INTERNAL;                                           \
+    }                                                                          \
+    ulist_status_e _err = (op);                                                \
+    pthread_rwlock_unlock(&(rw)->lock);                                        \
+    return _err;                                                               \
+} while (0)
+
+
+// Run a read operation while holding the read lock
+#define WITH_READ_LOCK(rw, op) do {                                            \
+    if (0 != _rw_read_lock(&(rw)->lock))                                       \
+    {                                                                          \
+        return ULIST_ERROR_INTERNAL;                                           \
+    }                                                                          \
+    ulist_status_e _err = (op);                                                \
+    _rw_read_unlock(&(rw)->lock);                                              \
+    return _err;                                                               \
+} while (0)
+
+
+#ifndef NDEBUG
+// Number of read locks per thread that are checked for nesting
+#define MAX_TRACKED_READ_LOCKS (8u)
+
+/* Read locks held by this thread. Locks taken while all slots are in use are
+ * not tracked, and can't be checked. */
+static _Thread_local pthread_rwlock_t *_read_locks[MAX_TRACKED_READ_LOCKS];
+
+
+// Find the slot tracking a read lock held by this thread
+static pthread_rwlock_t **_find_read_lock(pthread_rwlock_t *lock)
+{
+    for (size_t i = 0u; i < MAX_TRACKED_READ_LOCKS; i++)
+    {
+        if (lock == _read_locks[i])
+        {
+            return &_read_locks[i];
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+
+// Acquire the write lock, refusing if this thread holds the read lock
+static int _write_lock(pthread_rwlock_t *lock)
+{
+#ifndef NDEBUG
+    if (NULL != _find_read_lock(lock))
+    {
+        return EDEADLK;
+    }
+#endif
+
+    return pthread_rwlock_wrlock(lock);
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+int _rw_read_lock(pthread_rwlock_t *lock)
+{
+#ifndef NDEBUG
+    if (NULL != _find_read_lock(lock))
+    {
+        return EDEADLK;
+    }
+#endif
+
+    int ret = pthread_rwlock_rdlock(lock);
+
+#ifndef NDEBUG
+    pthread_rwlock_t **slot = _find_read_lock(NULL);
+
+    if ((0 == ret) && (NULL != slot))
+    {
+        *slot = lock;
+    }
+#endif
+
+    return ret;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _rw_read_unlock(pthread_rwlock_t *lock)
+{
+#ifndef NDEBUG
+    pthread_rwlock_t **slot = _find_read_lock(lock);
+
+    if (NULL != slot)
+    {
+        *slot = NULL;
+    }
+#endif
+
+    pthread_rwlock_unlock(lock);
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_create(ulist_rw_t *rw, size_t item_size_bytes,
+    size_t items_per_node)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_create(&rw->list, item_size_bytes,
+                                      items_per_node);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+
+#if defined(__GLIBC__)
+    /* glibc prefers readers by default, so readers re-acquiring the lock in a
+     * loop would starve the writers. With writers preferred, a nested read
+     * lock deadlocks as soon as a writer is waiting, which _rw_read_lock
+     * refuses in builds without NDEBUG. */
+    pthread_rwlockattr_setkind_np(&attr,
+        PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+
+    int ret = pthread_rwlock_init(&rw->lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+
+    if (0 != ret)
+    {
+        (void) ulist_destroy(&rw->list);
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_destroy(ulist_rw_t *rw)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_destroy(&rw->list);
+    if (ULIST_OK == err)
+    {
+        pthread_rwlock_destroy(&rw->lock);
+    }
+
+    return err;
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_append_item(ulist_rw_t *rw, void *item)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    WITH_WRITE_LOCK(rw, ulist_append_item(&rw->list, item));
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_insert_item(ulist_rw_t *rw, unsigned long long index,
+    void *item)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    WITH_WRITE_LOCK(rw, ulist_insert_item(&rw->list, index, item));
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_pop_item(ulist_rw_t *rw, unsigned long long index,
+    void *item)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    WITH_WRITE_LOCK(rw, ulist_pop_item(&rw->list, index, item));
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_get_item(ulist_rw_t *rw, unsigned long long index,
+    void *item)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    WITH_READ_LOCK(rw, ulist_get_item(&rw->list, index, item));
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_num_items(ulist_rw_t *rw, unsigned long long *num_items)
+{
+    if ((NULL == rw) || (NULL == num_items))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (0 != _rw_read_lock(&rw->lock))
+    {
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    *num_items = rw->list.num_items;
+    _rw_read_unlock(&rw->lock);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_iter_begin(ulist_rw_t *rw, ulist_rw_iter_t *iter,
+    unsigned long long index)
+{
+    if ((NULL == rw) || (NULL == iter))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (0 != _rw_read_lock(&rw->lock))
+    {
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    ulist_status_e err = ulist_iter_init(&rw->list, &iter->iter, index);
+    if (ULIST_OK != err)
+    {
+        _rw_read_unlock(&rw->lock);
+        iter->rw = NULL;
+        return err;
+    }
+
+    iter->rw = rw;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_iter_next(ulist_rw_iter_t *iter, const void **item)
+{
+    if ((NULL == iter) || (NULL == iter->rw))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    return ulist_iter_next(&iter->iter, item);
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_iter_previous(ulist_rw_iter_t *iter,
+    const void **item)
+{
+    if ((NULL == iter) || (NULL == iter->rw))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    return ulist_iter_previous(&iter->iter, item);
+}
+
+
+/**
+ * @see ulist_rw_api.h
+ */
+ulist_status_e ulist_rw_iter_end(ulist_rw_iter_t *iter)
+{
+    if ((NULL == iter) || (NULL == iter->rw))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    _rw_read_unlock(&iter->rw->lock);
+    iter->rw = NULL;
+    return ULIST_OK;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file   ulist_rw_api.h
+ * @author Erik Nyquist
+ * @brief  Thread-safe ulist wrapper with reader-writer locking
+ *
+ * Wraps a ulist instance with a reader-writer lock, so that any number of
+ * threads can read from the list at the same time, while threads adding or
+ * removing items get exclusive access. Each reader thread iterates with its
+ * own #ulist_rw_iter_t, which holds the read lock from #ulist_rw_iter_begin
+ * until #ulist_rw_iter_end.
+ *
+ * Read locks must not nest: a thread that holds the read lock, for example
+ * during an iteration, must not call any other function of the same list,
+ * reads included. Waiting writers are preferred over new readers so that they
+ * are not starved, which means a nested read lock deadlocks as soon as a
+ * writer is waiting. Unless NDEBUG is defined, such nested calls fail with
+ * ULIST_ERROR_INTERNAL instead.
+ */
+#ifndef ULIST_RW_API_H
+#define ULIST_RW_API_H
+
+#include <pthread.h>
+#include "ulist_api.h"
+
+
+/* Single thread-safe ulist instance */
+typedef struct {
+    ulist_t list;
+    pthread_rwlock_t lock;
+} ulist_rw_t;
+
+
+/* Per-reader iteration state for a thread-safe ulist instance */
+typedef struct {
+    ulist_rw_t *rw;
+    ulist_iter_t iter;
+} ulist_rw_iter_t;
+
+
+/**
+ * Initialize a thread-safe list instance.
+ *
+ * @param    rw              Uninitialized list structure to initialize
+ * @param    item_size_bytes Size of a single list item in bytes
+ * @Param    items_per_node  Number of items that each list node should hold
+ *
+ * @return   ULIST_OK        If list instance was initialized successfully
+ */
+ulist_status_e ulist_rw_create(ulist_rw_t *rw, size_t item_size_bytes,
+    size_t items_per_node);
+
+
+/**
+ * Destroy an initialized thread-safe list instance. No other threads may be
+ * accessing the list when this is called.
+ *
+ * @param    rw              List instance to destroy
+ *
+ * @return   ULIST_OK        If list instance was destroyed successfully
+ */
+ulist_status_e ulist_rw_destroy(ulist_rw_t *rw);
+
+
+/**
+ * Add an item to the end of a list, holding the write lock.
+ *
+ * @see #ulist_append_item
+ */
+ulist_status_e ulist_rw_append_item(ulist_rw_t *rw, void *item);
+
+
+/**
+ * Insert an item at a specific index in a list, holding the write lock.
+ *
+ * @see #ulist_insert_item
+ */
+ulist_status_e ulist_rw_insert_item(ulist_rw_t *rw, unsigned long long index,
+    void *item);
+
+
+/**
+ * Fetch and remove an item from a specific index in a list, holding the write
+ * lock.
+ *
+ * @see #ulist_pop_item
+ */
+ulist_status_e ulist_rw_pop_item(ulist_rw_t *rw, unsigned long long index,
+    void *item);
+
+
+/**
+ * Fetch an item from a specific index in a list, holding the read lock.
+ *
+ * @see #ulist_get_item
+ */
+ulist_status_e ulist_rw_get_item(ulist_rw_t *rw, unsigned long long index,
+    void *item);
+
+
+/**
+ * Query the number of items in a list, holding the read lock.
+ *
+ * @param    rw              List instance
+ * @param    num_items       Pointer to write number of items to
+ *
+ * @return   ULIST_OK        If the number of items was fetched successfully
+ */
+ulist_status_e ulist_rw_num_items(ulist_rw_t *rw, unsigned long long *num_items);
+
+
+/**
+ * Acquire the read lock and start iterating from a specific index. The read
+ * lock is held until #ulist_rw_iter_end is called, so writers will block until
+ * then; do not call any other function of the same list from the same thread
+ * before ending the iteration.
+ *
+ * @param    rw              List instance
+ * @param    iter            Iterator to initialize
+ * @param    index           List index of the first item to fetch
+ *
+ * @return   ULIST_OK        If the iteration was started successfully. On any
+ *                           other status the read lock is not held.
+ */
+ulist_status_e ulist_rw_iter_begin(ulist_rw_t *rw, ulist_rw_iter_t *iter,
+    unsigned long long index);
+
+
+/**
+ * Fetch a read-only pointer to the next item in an iteration started with
+ * #ulist_rw_iter_begin.
+ *
+ * @see #ulist_iter_next
+ */
+ulist_status_e ulist_rw_iter_next(ulist_rw_iter_t *iter, const void **item);
+
+
+/**
+ * Fetch a read-only pointer to the previous item in an iteration started with
+ * #ulist_rw_iter_begin.
+ *
+ * @see #ulist_iter_previous
+ */
+ulist_status_e ulist_rw_iter_previous(ulist_rw_iter_t *iter,
+    const void **item);
+
+
+/**
+ * End an iteration started with #ulist_rw_iter_begin and release the read
+ * lock. Item pointers fetched during the iteration must not be used after this.
+ *
+ * @param    iter            Iterator to end
+ *
+ * @return   ULIST_OK        If the iteration was ended successfully
+ */
+ulist_status_e ulist_rw_iter_end(ulist_rw_iter_t *iter);
+
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file   ulist_snapshot.c
+ * @author Erik Nyquist
+ * @brief  Read-copy-update snapshots of ulist instances
+ */
+#include <string.h>
+#include "ulist_snapshot_api.h"
+#include "ulist_internal.h"
+
+
+/**
+ * @see ulist_snapshot_api.h
+ */
+ulist_status_e ulist_snapshot_acquire(ulist_t *list,
+    ulist_snapshot_t *snapshot)
+{
+    if ((NULL == list) || (NULL == list->tail) || (NULL != list->spill)
+        || (NULL == snapshot))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    size_t num_nodes = (size_t) list->nodes;
+    ulist_node_t **nodes;
+
+    // Node pointers and first indices share a single allocation
+    if ((nodes = malloc(num_nodes * (sizeof(ulist_node_t *)
+                        + sizeof(unsigned long long)))) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    unsigned long long *first_index = (unsigned long long *) (nodes + num_nodes);
+    unsigned long long index = 0u;
+    size_t i = 0u;
+
+    for (ulist_node_t *node = list->head; NULL != node; node = node->next)
+    {
+        __atomic_add_fetch(&node->refs, 1u, __ATOMIC_RELAXED);
+        nodes[i] = node;
+        first_index[i] = index;
+        index += node->used;
+        i += 1u;
+    }
+
+    snapshot->nodes = nodes;
+    snapshot->first_index = first_index;
+    snapshot->num_nodes = num_nodes;
+    snapshot->num_items = list->num_items;
+    snapshot->item_size_bytes = list->item_size_bytes;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_snapshot_api.h
+ */
+ulist_status_e ulist_rw_snapshot_acquire(ulist_rw_t *rw,
+    ulist_snapshot_t *snapshot)
+{
+    if (NULL == rw)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    /* Snapshots only touch the node reference counts, which are atomic, so
+     * several readers can take snapshots at once */
+    if (0 != _rw_read_lock(&rw->lock))
+    {
+        return ULIST_ERROR_INTERNAL;
+    }
+
+    ulist_status_e err = ulist_snapshot_acquire(&rw->list, snapshot);
+    _rw_read_unlock(&rw->lock);
+    return err;
+}
+
+
+/**
+ * @see ulist_snapshot_api.h
+ */
+ulist_status_e ulist_snapshot_release(ulist_snapshot_t *snapshot)
+{
+    if ((NULL == snapshot) || (NULL == snapshot->nodes))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    for (size_t i = 0u; i < snapshot->num_nodes; i++)
+    {
+        _release_node(snapshot->nodes[i]);
+    }
+
+    free(snapshot->nodes);
+    snapshot->nodes = NULL;
+    snapshot->first_index = NULL;
+    return ULIST_OK;
+}
+
+
+// Find the position of the node holding a specific item
+static size_t _find_node(ulist_snapshot_t *snapshot, unsigned long long index)
+{
+    size_t low = 0u;
+    size_t high = snapshot->num_nodes - 1u;
+
+    // Last node whose first index is not past the target
+    while (low < high)
+    {
+        size_t mid = low + ((high - low + 1u) / 2u);
+
+        if (snapshot->first_index[mid] <= index)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid - 1u;
+        }
+    }
+
+    return low;
+}
+
+
+/**
+ * @see ulist_snapshot_api.h
+ */
+ulist_status_e ulist_snapshot_get_item(ulist_snapshot_t *snapshot,
+    unsigned long long index, void *item)
+{
+    if ((NULL == snapshot) || (NULL == snapshot->nodes) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= snapshot->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    size_t i = _find_node(snapshot, index);
+    size_t local_index = index - snapshot->first_index[i];
+
+    memcpy(item, snapshot->nodes[i]->items
+                 + (local_index * snapshot->item_size_bytes),
+           snapshot->item_size_bytes);
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_snapshot_api.h
+ */
+ulist_status_e ulist_snapshot_iter_init(ulist_snapshot_t *snapshot,
+    ulist_snapshot_iter_t *iter, unsigned long long index)
+{
+    if ((NULL == snapshot) || (NULL == snapshot->nodes) || (NULL == iter))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    iter->snapshot = snapshot;
+
+    if (0u == snapshot->num_items)
+    {
+        // Nothing to iterate over
+        if (0u != index)
+        {
+            return ULIST_INDEX_OUT_OF_RANGE;
+        }
+
+        iter->node_index = snapshot->num_nodes;
+        iter->local_index = 0u;
+        return ULIST_OK;
+    }
+
+    if (index >= snapshot->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    iter->node_index = _find_node(snapshot, index);
+    iter->local_index = index - snapshot->first_index[iter->node_index];
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_snapshot_api.h
+ */
+ulist_status_e ulist_snapshot_iter_next(ulist_snapshot_iter_t *iter,
+    void **item)
+{
+    if ((NULL == iter) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_snapshot_t *snapshot = iter->snapshot;
+
+    // Reached the end of this node-- jump to the next one
+    while ((iter->node_index < snapshot->num_nodes)
+           && (iter->local_index >= snapshot->nodes[iter->node_index]->used))
+    {
+        iter->node_index += 1u;
+        iter->local_index = 0u;
+    }
+
+    if (iter->node_index >= snapshot->num_nodes)
+    {
+        return ULIST_END;
+    }
+
+    *item = snapshot->nodes[iter->node_index]->items
+            + (iter->local_index * snapshot->item_size_bytes);
+    iter->local_index += 1u;
+
+    return ULIST_OK;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file   ulist_snapshot_api.h
+ * @author Erik Nyquist
+ * @brief  Read-copy-update snapshots of ulist instances
+ *
+ * A snapshot is a stable, read-only view of the items in a list at the time
+ * it was acquired. Acquiring a snapshot takes a reference on every node in the
+ * list, and records the nodes in order. After that, the list can continue to
+ * be modified while the snapshot is read without any locking: before changing
+ * the contents of a node that is held by a snapshot, the list replaces it with
+ * a private copy, leaving the original untouched. Nodes that have been
+ * replaced or removed from the list are freed when the last snapshot holding
+ * them is released.
+ *
+ * Acquiring a snapshot must not run at the same time as any operation that
+ * modifies the list (with #ulist_rw_t, use #ulist_rw_snapshot_acquire).
+ * Releasing and reading snapshots can happen on any thread at any time, and a
+ * snapshot may outlive the list it was taken from.
+ */
+#ifndef ULIST_SNAPSHOT_API_H
+#define ULIST_SNAPSHOT_API_H
+
+#include "ulist_api.h"
+#include "ulist_rw_api.h"
+
+
+/* Read-only view of a list at a single point in time */
+typedef struct {
+    ulist_node_t **nodes;             // Nodes held by the snapshot, in order
+    unsigned long long *first_index;  // List index of first item in each node
+    size_t num_nodes;
+    unsigned long long num_items;
+    size_t item_size_bytes;
+} ulist_snapshot_t;
+
+
+/* Iteration state for reading items from a snapshot in order */
+typedef struct {
+    ulist_snapshot_t *snapshot;
+    size_t node_index;
+    size_t local_index;
+} ulist_snapshot_iter_t;
+
+
+/**
+ * Take a snapshot of the current contents of a list. Nothing can be modifying
+ * the list while this runs.
+ *
+ * @param    list            List instance
+ * @param    snapshot        Snapshot structure to initialize
+ *
+ * @return   ULIST_OK        If the snapshot was acquired successfully
+ */
+ulist_status_e ulist_snapshot_acquire(ulist_t *list,
+    ulist_snapshot_t *snapshot);
+
+
+/**
+ * Take a snapshot of a thread-safe list, holding the read lock only while the
+ * snapshot is being taken.
+ *
+ * @see #ulist_snapshot_acquire
+ */
+ulist_status_e ulist_rw_snapshot_acquire(ulist_rw_t *rw,
+    ulist_snapshot_t *snapshot);
+
+
+/**
+ * Release a snapshot. Nodes that are no longer in the list or in any other
+ * snapshot are freed. Item pointers fetched from the snapshot must not be used
+ * after this.
+ *
+ * @param    snapshot        Snapshot to release
+ *
+ * @return   ULIST_OK        If the snapshot was released successfully
+ */
+ulist_status_e ulist_snapshot_release(ulist_snapshot_t *snapshot);
+
+
+/**
+ * Fetch an item from a specific index in a snapshot.
+ *
+ * @param    snapshot        Snapshot instance
+ * @param    index           List index of item to fetch
+ * @param    item            Pointer to location to copy item to
+ *
+ * @return   ULIST_OK        If the item was fetched successfully
+ */
+ulist_status_e ulist_snapshot_get_item(ulist_snapshot_t *snapshot,
+    unsigned long long index, void *item);
+
+
+/**
+ * Start iterating over a snapshot from a specific index.
+ *
+ * @param    snapshot        Snapshot instance
+ * @param    iter            Iterator to initialize
+ * @param    index           List index of the first item to fetch
+ *
+ * @return   ULIST_OK        If the iterator was initialized successfully
+ */
+ulist_status_e ulist_snapshot_iter_init(ulist_snapshot_t *snapshot,
+    ulist_snapshot_iter_t *iter, unsigned long long index);
+
+
+/**
+ * Fetch a pointer to the next item in a snapshot. The item must not be
+ * modified through the pointer.
+ *
+ * @param    iter            Iterator instance
+ * @param    item            Pointer to location to store item pointer
+ *
+ * @return   ULIST_OK        If the item was fetched successfully
+ * @return   ULIST_END       If there are no more items
+ */
+ulist_status_e ulist_snapshot_iter_next(ulist_snapshot_iter_t *iter,
+    void **item);
+
+
+#endif
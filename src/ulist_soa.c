@@ -0,0 +1,466 @@
+/**
+ * @file   ulist_soa.c
+ * @author Erik Nyquist
+ * @brief  ulist with a struct-of-arrays node layout, for multi-field records
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "ulist_soa_api.h"
+#include "ulist_internal.h"
+
+
+// Offset of the items from the start of each node
+#define ITEMS_OFFSET (ROUND_UP(sizeof(ulist_node_t), ULIST_SOA_COLUMN_ALIGN))
+
+// Start of the column for a field in a node
+#define COLUMN(soa, node, f) ((node)->items + (soa)->column_offsets[f])
+
+// Field f of the record at local index i of a node
+#define FIELD(soa, node, f, i) (COLUMN(soa, node, f) + \
+                                ((i) * (soa)->field_bytes[f]))
+
+
+/* Copy count records between two nodes, or within one node, one column at a
+ * time. Overlapping ranges are allowed. */
+static void _copy_records(ulist_soa_t *soa, ulist_node_t *dest,
+    size_t dest_index, ulist_node_t *src, size_t src_index, size_t count)
+{
+    for (size_t f = 0u; f < soa->num_fields; f++)
+    {
+        memmove(FIELD(soa, dest, f, dest_index), FIELD(soa, src, f, src_index),
+                count * soa->field_bytes[f]);
+    }
+}
+
+
+// Add a record at local index i of a node that is not full
+static void _node_insert(ulist_soa_t *soa, ulist_node_t *node, size_t i,
+    const void *record)
+{
+    _copy_records(soa, node, i + 1u, node, i, node->used - i);
+
+    for (size_t f = 0u; f < soa->num_fields; f++)
+    {
+        memcpy(FIELD(soa, node, f, i), (const char *) record
+               + soa->field_offsets[f], soa->field_bytes[f]);
+    }
+
+    node->used += 1u;
+}
+
+
+// Remove the record at local index i of a node, copying it out if not NULL
+static void _node_remove(ulist_soa_t *soa, ulist_node_t *node, size_t i,
+    void *record)
+{
+    if (NULL != record)
+    {
+        for (size_t f = 0u; f < soa->num_fields; f++)
+        {
+            memcpy((char *) record + soa->field_offsets[f],
+                   FIELD(soa, node, f, i), soa->field_bytes[f]);
+        }
+    }
+
+    _copy_records(soa, node, i, node, i + 1u, node->used - i - 1u);
+    node->used -= 1u;
+}
+
+
+/* Allocate a node with its items aligned for the columns. The regular node
+ * allocation has no room for the padding between columns. */
+static ulist_node_t *_alloc_soa_node(ulist_soa_t *soa)
+{
+    ulist_node_t *node;
+
+    if ((node = aligned_alloc(ULIST_SOA_COLUMN_ALIGN, soa->node_bytes)) == NULL)
+    {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(ulist_node_t));
+    node->refs = 1u;
+    node->capacity = soa->list.items_per_node;
+    node->items = (char *) node + ITEMS_OFFSET;
+    return node;
+}
+
+
+// Allocate a node and connect it after node
+static ulist_node_t *_add_node_after(ulist_soa_t *soa, ulist_node_t *node)
+{
+    ulist_t *list = &soa->list;
+    ulist_node_t *new;
+
+    if ((new = _alloc_soa_node(soa)) == NULL)
+    {
+        return NULL;
+    }
+
+    new->previous = node;
+    new->next = node->next;
+
+    if (NULL != node->next)
+    {
+        node->next->previous = new;
+    }
+    else
+    {
+        list->tail = new;
+    }
+
+    node->next = new;
+    list->nodes += 1u;
+    return new;
+}
+
+
+// Free an empty node and connect the nodes on either side of it
+static void _delete_node(ulist_soa_t *soa, ulist_node_t *node)
+{
+    ulist_t *list = &soa->list;
+
+    if (NULL != node->next)
+    {
+        node->next->previous = node->previous;
+    }
+    else
+    {
+        list->tail = node->previous;
+    }
+
+    if (NULL != node->previous)
+    {
+        node->previous->next = node->next;
+    }
+    else
+    {
+        list->head = node->next;
+    }
+
+    _free_node(list, node);
+    list->nodes -= 1u;
+}
+
+
+/* Move count records from the near end of src into node. src is the node
+ * right after or right before node. */
+static void _take_records(ulist_soa_t *soa, ulist_node_t *node,
+    ulist_node_t *src, size_t count)
+{
+    if (src == node->next)
+    {
+        _copy_records(soa, node, node->used, src, 0u, count);
+        _copy_records(soa, src, 0u, src, count, src->used - count);
+    }
+    else
+    {
+        _copy_records(soa, node, count, node, 0u, node->used);
+        _copy_records(soa, node, 0u, src, src->used - count, count);
+    }
+
+    node->used += count;
+    src->used -= count;
+}
+
+
+// Find the node holding a record, and the record's index within that node
+static ulist_node_t *_find_record(ulist_soa_t *soa, unsigned long long index,
+    size_t *local_index)
+{
+    ulist_t *list = &soa->list;
+    ulist_node_t *node;
+
+    if (index < (list->num_items / 2u))
+    {
+        for (node = list->head; index >= node->used; node = node->next)
+        {
+            index -= node->used;
+        }
+
+        *local_index = (size_t) index;
+    }
+    else
+    {
+        unsigned long long start = list->num_items - list->tail->used;
+
+        for (node = list->tail; index < start; node = node->previous)
+        {
+            start -= node->previous->used;
+        }
+
+        *local_index = (size_t) (index - start);
+    }
+
+    return node;
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_create(ulist_soa_t *soa, const size_t *field_bytes,
+    size_t num_fields, size_t items_per_node)
+{
+    if ((NULL == soa) || (NULL == field_bytes) || (0u == num_fields)
+        || (num_fields > ULIST_SOA_MAX_FIELDS))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    size_t record_bytes = 0u;
+
+    for (size_t f = 0u; f < num_fields; f++)
+    {
+        if (0u == field_bytes[f])
+        {
+            return ULIST_INVALID_PARAM;
+        }
+
+        soa->field_bytes[f] = field_bytes[f];
+        soa->field_offsets[f] = record_bytes;
+        record_bytes += field_bytes[f];
+    }
+
+    soa->num_fields = num_fields;
+
+    // A node holds items_per_node records either way, just laid out by field
+    ulist_status_e err = ulist_create(&soa->list, record_bytes, items_per_node);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    // Each column starts on an aligned boundary, after any padding
+    size_t column_bytes = 0u;
+
+    for (size_t f = 0u; f < num_fields; f++)
+    {
+        column_bytes = ROUND_UP(column_bytes, ULIST_SOA_COLUMN_ALIGN);
+        soa->column_offsets[f] = column_bytes;
+        column_bytes += items_per_node * field_bytes[f];
+    }
+
+    soa->node_bytes = ROUND_UP(ITEMS_OFFSET + column_bytes,
+                               ULIST_SOA_COLUMN_ALIGN);
+
+    // Swap the regular head node for one laid out for the columns
+    ulist_node_t *head;
+
+    if ((head = _alloc_soa_node(soa)) == NULL)
+    {
+        (void) ulist_destroy(&soa->list);
+        return ULIST_ERROR_MEM;
+    }
+
+    _free_node(&soa->list, soa->list.head);
+    soa->list.head = head;
+    soa->list.tail = head;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_destroy(ulist_soa_t *soa)
+{
+    return (NULL == soa) ? ULIST_INVALID_PARAM : ulist_destroy(&soa->list);
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_append(ulist_soa_t *soa, const void *record)
+{
+    return ulist_soa_insert(soa, (NULL == soa) ? 0u : soa->list.num_items,
+                            record);
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_insert(ulist_soa_t *soa, unsigned long long index,
+    const void *record)
+{
+    if ((NULL == soa) || (NULL == soa->list.tail) || (NULL == record))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_t *list = &soa->list;
+
+    if (index > list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    ulist_node_t *node = list->tail;
+    size_t i = node->used;
+
+    if (index < list->num_items)
+    {
+        node = _find_record(soa, index, &i);
+    }
+
+    // Record goes at the end of the previous node, if it has room
+    if ((0u == i) && (NULL != node->previous)
+        && (node->previous->used < node->previous->capacity))
+    {
+        node = node->previous;
+        i = node->used;
+    }
+
+    if (node->used == node->capacity)
+    {
+        ulist_node_t *new;
+
+        if ((new = _add_node_after(soa, node)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        if (i == node->used)
+        {
+            // Record goes at the start of the new node
+            node = new;
+            i = 0u;
+        }
+        else
+        {
+            // Split the full node in half
+            _take_records(soa, new, node, node->used / 2u);
+
+            if (i > node->used)
+            {
+                i -= node->used;
+                node = new;
+            }
+        }
+    }
+
+    _node_insert(soa, node, i, record);
+    list->num_items += 1u;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_get(ulist_soa_t *soa, unsigned long long index,
+    void *record)
+{
+    if ((NULL == soa) || (NULL == soa->list.tail) || (NULL == record))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    if (index >= soa->list.num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    size_t i;
+    ulist_node_t *node = _find_record(soa, index, &i);
+
+    for (size_t f = 0u; f < soa->num_fields; f++)
+    {
+        memcpy((char *) record + soa->field_offsets[f],
+               FIELD(soa, node, f, i), soa->field_bytes[f]);
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_pop(ulist_soa_t *soa, unsigned long long index,
+    void *record)
+{
+    if ((NULL == soa) || (NULL == soa->list.tail))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_t *list = &soa->list;
+
+    if (index >= list->num_items)
+    {
+        return ULIST_INDEX_OUT_OF_RANGE;
+    }
+
+    size_t i;
+    ulist_node_t *node = _find_record(soa, index, &i);
+
+    _node_remove(soa, node, i, record);
+    list->num_items -= 1u;
+
+    ulist_node_t *src = (NULL != node->next) ? node->next : node->previous;
+
+    if ((NULL == src) || (node->used > (node->capacity / 2u)))
+    {
+        // Node is over half full, or is the only node; nothing else to do
+        return ULIST_OK;
+    }
+
+    if ((node->used + src->used) <= node->capacity)
+    {
+        // Both nodes fit in one
+        _take_records(soa, node, src, src->used);
+        _delete_node(soa, src);
+    }
+    else
+    {
+        _take_records(soa, node, src, (node->capacity / 2u) - node->used);
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_iter_init(ulist_soa_t *soa, ulist_soa_iter_t *iter,
+    size_t field)
+{
+    if ((NULL == soa) || (NULL == soa->list.tail) || (NULL == iter)
+        || (field >= soa->num_fields))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    iter->soa = soa;
+    iter->node = soa->list.head;
+    iter->field = field;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_soa_api.h
+ */
+ulist_status_e ulist_soa_iter_next(ulist_soa_iter_t *iter, void **items,
+    size_t *count)
+{
+    if ((NULL == iter) || (NULL == items) || (NULL == count))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    // Only the node of an empty list can be empty
+    if ((NULL == iter->node) || (0u == iter->node->used))
+    {
+        return ULIST_END;
+    }
+
+    *items = COLUMN(iter->soa, iter->node, iter->field);
+    *count = iter->node->used;
+    iter->node = iter->node->next;
+    return ULIST_OK;
+}
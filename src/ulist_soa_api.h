@@ -0,0 +1,163 @@
+/**
+ * @file   ulist_soa_api.h
+ * @author Erik Nyquist
+ * @brief  ulist with a struct-of-arrays node layout, for multi-field records
+ *
+ * A regular list stores each item as one contiguous block, so reading a
+ * single field of every record also pulls the other fields through the
+ * cache. A struct-of-arrays (SoA) list is created from a schema listing the
+ * size of each field of a record, and each node stores one contiguous column
+ * per field: first the first field of every record in the node, then the
+ * second field of every record, and so on.
+ *
+ * Whole records are added, fetched and removed in their packed form, with the
+ * fields in schema order and no padding between them. A single field can be
+ * scanned on its own with #ulist_soa_iter_next, which hands out one column of
+ * one node at a time. Each column starts on a multiple of
+ * #ULIST_SOA_COLUMN_ALIGN, with padding between the columns of a node.
+ */
+#ifndef ULIST_SOA_API_H
+#define ULIST_SOA_API_H
+
+#include <stddef.h>
+#include "ulist_api.h"
+
+
+/* Maximum number of fields in a record */
+#define ULIST_SOA_MAX_FIELDS (16u)
+
+
+/* Alignment of the start of each column in a node */
+#define ULIST_SOA_COLUMN_ALIGN (_Alignof(max_align_t))
+
+
+/* Single SoA list instance */
+typedef struct {
+    ulist_t list;             // Node parameters and links. item_size_bytes is
+                              // the size of a whole record. Only
+                              // ulist_soa_* functions may be used on it.
+    size_t num_fields;
+    size_t field_bytes[ULIST_SOA_MAX_FIELDS];     // Size of each field
+    size_t field_offsets[ULIST_SOA_MAX_FIELDS];   // Offset of each field in a
+                                                  // packed record
+    size_t column_offsets[ULIST_SOA_MAX_FIELDS];  // Start of each column in
+                                                  // the items of a node
+    size_t node_bytes;                            // Allocated for each node
+} ulist_soa_t;
+
+
+/* Iteration state for scanning one field of a list, a node at a time */
+typedef struct {
+    ulist_soa_t *soa;
+    ulist_node_t *node;
+    size_t field;
+} ulist_soa_iter_t;
+
+
+/**
+ * Initialize a SoA list instance.
+ *
+ * @param    soa             Uninitialized list structure to initialize
+ * @param    field_bytes     Size of each field of a record in bytes
+ * @param    num_fields      Number of fields, at most #ULIST_SOA_MAX_FIELDS
+ * @param    items_per_node  Number of records that each node should hold
+ *
+ * @return   ULIST_OK        If list instance was initialized successfully
+ */
+ulist_status_e ulist_soa_create(ulist_soa_t *soa, const size_t *field_bytes,
+    size_t num_fields, size_t items_per_node);
+
+
+/**
+ * Destroy an initialized SoA list instance.
+ *
+ * @param    soa             List instance to destroy
+ *
+ * @return   ULIST_OK        If list instance was destroyed successfully
+ */
+ulist_status_e ulist_soa_destroy(ulist_soa_t *soa);
+
+
+/**
+ * Add a record to the end of a list.
+ *
+ * @param    soa             List instance
+ * @param    record          Pointer to packed record to add
+ *
+ * @return   ULIST_OK        If record was added successfully
+ */
+ulist_status_e ulist_soa_append(ulist_soa_t *soa, const void *record);
+
+
+/**
+ * Insert a record at a specific index in a list.
+ *
+ * @param    soa             List instance
+ * @param    index           List index to insert the record at
+ * @param    record          Pointer to packed record to insert
+ *
+ * @return   ULIST_OK        If record was inserted successfully
+ */
+ulist_status_e ulist_soa_insert(ulist_soa_t *soa, unsigned long long index,
+    const void *record);
+
+
+/**
+ * Fetch the record at a specific index in a list.
+ *
+ * @param    soa             List instance
+ * @param    index           List index of record to fetch
+ * @param    record          Pointer to location to copy the packed record to
+ *
+ * @return   ULIST_OK        If record was fetched successfully
+ */
+ulist_status_e ulist_soa_get(ulist_soa_t *soa, unsigned long long index,
+    void *record);
+
+
+/**
+ * Fetch and remove the record at a specific index in a list.
+ *
+ * @param    soa             List instance
+ * @param    index           List index of record to remove
+ * @param    record          Pointer to location to copy the packed record
+ *                           to, or NULL to discard it
+ *
+ * @return   ULIST_OK        If record was removed successfully
+ */
+ulist_status_e ulist_soa_pop(ulist_soa_t *soa, unsigned long long index,
+    void *record);
+
+
+/**
+ * Initialize an iterator over one field of every record in a list.
+ *
+ * @param    soa             List instance
+ * @param    iter            Iterator to initialize
+ * @param    field           Index of the field to scan, in schema order
+ *
+ * @return   ULIST_OK        If the iterator was initialized successfully
+ */
+ulist_status_e ulist_soa_iter_init(ulist_soa_t *soa, ulist_soa_iter_t *iter,
+    size_t field);
+
+
+/**
+ * Fetch the column of the next node for the field being scanned. The column
+ * holds the field of count consecutive records, field_bytes[field] bytes
+ * apart. It starts on a multiple of #ULIST_SOA_COLUMN_ALIGN, so it can be
+ * read as an array of any type of that size, such as uint64_t or double. The
+ * pointer becomes invalid if records are added or removed.
+ *
+ * @param    iter            Iterator initialized by #ulist_soa_iter_init
+ * @param    items           Pointer to copy the column pointer to
+ * @param    count           Pointer to write the number of records to
+ *
+ * @return   ULIST_OK        If a column was fetched successfully
+ * @return   ULIST_END       If there are no more columns
+ */
+ulist_status_e ulist_soa_iter_next(ulist_soa_iter_t *iter, void **items,
+    size_t *count);
+
+
+#endif
@@ -0,0 +1,362 @@
+/**
+ * @file   ulist_spill.c
+ * @author Erik Nyquist
+ * @brief  ulist with cold nodes spilled to a file
+ */
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include "ulist_spill_api.h"
+#include "ulist_internal.h"
+
+
+// Slot number of a node that has never been written to the file
+#define SLOT_NONE (~0ull)
+
+// Head, tail, and two nodes being worked on
+#define MIN_RESIDENT_NODES (4u)
+
+// Spill bookkeeping, kept in the otherwise unused data area of node headers
+#define META(node) ((spill_meta_t *) (node)->data)
+
+
+struct ulist_spill {
+    int fd;
+    size_t block_bytes;             // Size of a node's items, and a file slot
+    ulist_node_t *lru_first;        // Most recently used resident node
+    ulist_node_t *lru_last;         // Least recently used resident node
+    unsigned long long *free_slots; // Slots of freed nodes, for reuse
+    size_t num_free_slots;
+    size_t free_slots_size;
+    ulist_spill_stats_t stats;
+};
+
+
+typedef struct {
+    ulist_node_t *lru_previous;     // More recently used resident node
+    ulist_node_t *lru_next;         // Less recently used resident node
+    unsigned long long slot;        // Slot in file, or SLOT_NONE
+    int dirty;                      // Items changed since last written
+} spill_meta_t;
+
+
+static void _lru_unlink(struct ulist_spill *spill, ulist_node_t *node)
+{
+    spill_meta_t *meta = META(node);
+
+    if (NULL != meta->lru_previous)
+    {
+        META(meta->lru_previous)->lru_next = meta->lru_next;
+    }
+    else
+    {
+        spill->lru_first = meta->lru_next;
+    }
+
+    if (NULL != meta->lru_next)
+    {
+        META(meta->lru_next)->lru_previous = meta->lru_previous;
+    }
+    else
+    {
+        spill->lru_last = meta->lru_previous;
+    }
+}
+
+
+static void _lru_push_front(struct ulist_spill *spill, ulist_node_t *node)
+{
+    spill_meta_t *meta = META(node);
+
+    meta->lru_previous = NULL;
+    meta->lru_next = spill->lru_first;
+
+    if (NULL != spill->lru_first)
+    {
+        META(spill->lru_first)->lru_previous = node;
+    }
+    else
+    {
+        spill->lru_last = node;
+    }
+
+    spill->lru_first = node;
+}
+
+
+// Read or write len bytes at offset, continuing after partial transfers
+static int _transfer(int fd, char *buf, size_t len, off_t offset, int writing)
+{
+    while (len > 0u)
+    {
+        ssize_t ret = (writing) ? pwrite(fd, buf, len, offset)
+                                : pread(fd, buf, len, offset);
+
+        if ((ret < 0) && (EINTR == errno))
+        {
+            continue;
+        }
+
+        if (ret <= 0)
+        {
+            return 0;
+        }
+
+        buf += ret;
+        len -= (size_t) ret;
+        offset += ret;
+    }
+
+    return 1;
+}
+
+
+/* Write the items of the least recently used node that isn't the head, tail,
+ * or most recently used node to the file, and free them. If there is no such
+ * node, the budget is exceeded for now. Returns 0 if writing failed. */
+static int _evict_one(ulist_t *list)
+{
+    struct ulist_spill *spill = list->spill;
+    ulist_node_t *node = spill->lru_last;
+
+    while ((NULL != node) && ((node == list->head) || (node == list->tail)
+                              || (node == spill->lru_first)))
+    {
+        node = META(node)->lru_previous;
+    }
+
+    if (NULL == node)
+    {
+        return 1;
+    }
+
+    spill_meta_t *meta = META(node);
+
+    if (SLOT_NONE == meta->slot)
+    {
+        meta->slot = (spill->num_free_slots > 0u)
+                     ? spill->free_slots[--spill->num_free_slots]
+                     : spill->stats.file_slots++;
+        meta->dirty = 1;
+    }
+
+    if (meta->dirty)
+    {
+        if (!_transfer(spill->fd, node->items,
+                       node->used * list->item_size_bytes,
+                       (off_t) (meta->slot * spill->block_bytes), 1))
+        {
+            return 0;
+        }
+
+        spill->stats.writes += 1u;
+    }
+
+    _lru_unlink(spill, node);
+    free(node->items);
+    node->items = NULL;
+    meta->dirty = 0;
+
+    spill->stats.resident_nodes -= 1u;
+    spill->stats.evictions += 1u;
+    return 1;
+}
+
+
+// Allocate memory for the items of a node, evicting another node if needed
+static char *_alloc_block(ulist_t *list)
+{
+    struct ulist_spill *spill = list->spill;
+
+    if ((spill->stats.resident_nodes >= spill->stats.max_resident_nodes)
+        && !_evict_one(list))
+    {
+        return NULL;
+    }
+
+    return malloc(spill->block_bytes);
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+int _spill_use(ulist_t *list, ulist_node_t *node, int dirty)
+{
+    struct ulist_spill *spill = list->spill;
+    spill_meta_t *meta = META(node);
+
+    if (NULL != node->items)
+    {
+        _lru_unlink(spill, node);
+        _lru_push_front(spill, node);
+        meta->dirty |= dirty;
+        return 1;
+    }
+
+    char *block;
+
+    if ((block = _alloc_block(list)) == NULL)
+    {
+        return 0;
+    }
+
+    if (!_transfer(spill->fd, block, node->used * list->item_size_bytes,
+                   (off_t) (meta->slot * spill->block_bytes), 0))
+    {
+        free(block);
+        return 0;
+    }
+
+    node->items = block;
+    meta->dirty = dirty;
+    _lru_push_front(spill, node);
+
+    spill->stats.resident_nodes += 1u;
+    spill->stats.loads += 1u;
+    return 1;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+ulist_node_t *_spill_alloc_node(ulist_t *list)
+{
+    struct ulist_spill *spill = list->spill;
+    ulist_node_t *node;
+
+    if ((node = malloc(sizeof(ulist_node_t) + sizeof(spill_meta_t))) == NULL)
+    {
+        return NULL;
+    }
+
+    memset(node, 0, sizeof(ulist_node_t) + sizeof(spill_meta_t));
+
+    if ((node->items = _alloc_block(list)) == NULL)
+    {
+        free(node);
+        return NULL;
+    }
+
+    node->refs = 1u;
+    node->capacity = list->items_per_node;
+    META(node)->slot = SLOT_NONE;
+    META(node)->dirty = 1;
+    _lru_push_front(spill, node);
+
+    spill->stats.resident_nodes += 1u;
+    return node;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _spill_free_node(ulist_t *list, ulist_node_t *node)
+{
+    struct ulist_spill *spill = list->spill;
+    spill_meta_t *meta = META(node);
+
+    if (NULL != node->items)
+    {
+        _lru_unlink(spill, node);
+        free(node->items);
+        spill->stats.resident_nodes -= 1u;
+    }
+
+    if (SLOT_NONE != meta->slot)
+    {
+        // Keep the slot for reuse; if that fails, the slot just goes unused
+        if (spill->num_free_slots == spill->free_slots_size)
+        {
+            size_t new_size = MAX(16u, spill->free_slots_size * 2u);
+            unsigned long long *slots = realloc(spill->free_slots,
+                                                new_size * sizeof(*slots));
+            if (NULL != slots)
+            {
+                spill->free_slots = slots;
+                spill->free_slots_size = new_size;
+            }
+        }
+
+        if (spill->num_free_slots < spill->free_slots_size)
+        {
+            spill->free_slots[spill->num_free_slots++] = meta->slot;
+        }
+    }
+
+    free(node);
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+void _spill_destroy(ulist_t *list)
+{
+    free(list->spill->free_slots);
+    free(list->spill);
+    list->spill = NULL;
+}
+
+
+/**
+ * @see ulist_spill_api.h
+ */
+ulist_status_e ulist_spill_create(ulist_t *list, size_t item_size_bytes,
+    size_t items_per_node, int fd, size_t memory_bytes)
+{
+    if (fd < 0)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_create(list, item_size_bytes, items_per_node);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    struct ulist_spill *spill;
+
+    if ((spill = calloc(1u, sizeof(struct ulist_spill))) == NULL)
+    {
+        (void) ulist_destroy(list);
+        return ULIST_ERROR_MEM;
+    }
+
+    spill->fd = fd;
+    spill->block_bytes = item_size_bytes * items_per_node;
+    spill->stats.max_resident_nodes = MAX(memory_bytes / spill->block_bytes,
+                                          MIN_RESIDENT_NODES);
+
+    // Swap the regular head node for one with a separate item block
+    _free_node(list, list->head);
+    list->spill = spill;
+
+    if ((list->head = _alloc_node(list)) == NULL)
+    {
+        _spill_destroy(list);
+        list->tail = NULL;
+        return ULIST_ERROR_MEM;
+    }
+
+    list->tail = list->head;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_spill_api.h
+ */
+ulist_status_e ulist_spill_get_stats(ulist_t *list, ulist_spill_stats_t *stats)
+{
+    if ((NULL == list) || (NULL == list->spill) || (NULL == stats))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    *stats = list->spill->stats;
+    return ULIST_OK;
+}
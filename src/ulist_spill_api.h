@@ -0,0 +1,69 @@
+/**
+ * @file   ulist_spill_api.h
+ * @author Erik Nyquist
+ * @brief  ulist with cold nodes spilled to a file
+ *
+ * A spill list works like a regular list, but only keeps the items of a
+ * limited number of nodes in memory. Node headers (links and item counts)
+ * always stay in memory, so crawling the list to find an index never touches
+ * the file. When the items of a node are needed and the memory budget is used
+ * up, the items of the least recently used node are written to a slot in the
+ * file and freed, and the node's items are read back in from its slot the next
+ * time they are needed. The items of the head and tail nodes are never
+ * evicted.
+ *
+ * Item pointers returned by #ulist_get_item_pointer, #ulist_get_next_item and
+ * the ulist_iter_* functions are only valid until the next call on the same
+ * list, since that call may evict the node holding the item. Spill lists can't
+ * be used with snapshots, clones, persistent versions, ulist_save or the
+ * parallel functions.
+ */
+#ifndef ULIST_SPILL_API_H
+#define ULIST_SPILL_API_H
+
+#include "ulist_api.h"
+
+
+/* Counters for a spill list */
+typedef struct {
+    unsigned long long resident_nodes;      // Nodes with items in memory
+    unsigned long long max_resident_nodes;  // Budget, in nodes
+    unsigned long long loads;               // Nodes read back in from file
+    unsigned long long evictions;           // Nodes evicted from memory
+    unsigned long long writes;              // Nodes written to file
+    unsigned long long file_slots;          // Node-sized slots in the file
+} ulist_spill_stats_t;
+
+
+/**
+ * Initialize a list instance that spills the items of cold nodes to a file.
+ * The file is used from offset 0 and overwritten; it should be a local file
+ * that isn't used for anything else, and can be closed once the list is
+ * destroyed.
+ *
+ * @param    list            Uninitialized list structure to initialize
+ * @param    item_size_bytes Size of a single list item in bytes
+ * @Param    items_per_node  Number of items that each list node should hold
+ * @param    fd              File descriptor of the file to spill nodes to
+ * @param    memory_bytes    Memory budget for node items. At least four nodes
+ *                           are kept in memory, whatever the budget.
+ *
+ * @return   ULIST_OK        If list instance was initialized successfully
+ */
+ulist_status_e ulist_spill_create(ulist_t *list, size_t item_size_bytes,
+    size_t items_per_node, int fd, size_t memory_bytes);
+
+
+/**
+ * Fetch the counters of a spill list.
+ *
+ * @param    list            List instance created with #ulist_spill_create
+ * @param    stats           Pointer to write counters to
+ *
+ * @return   ULIST_OK        If the counters were fetched successfully
+ */
+ulist_status_e ulist_spill_get_stats(ulist_t *list,
+    ulist_spill_stats_t *stats);
+
+
+#endif
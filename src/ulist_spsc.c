@@ -0,0 +1,161 @@
+/**
+ * @file   ulist_spsc.c
+ * @author Erik Nyquist
+ * @brief  Lock-free single-producer/single-consumer queue built on ulist nodes
+ */
+#include <string.h>
+#include "ulist_spsc_api.h"
+#include "ulist_internal.h"
+
+
+/* Get an empty node for the producer, reusing one the consumer has finished
+ * with if possible. Nodes from queue->first up to (not including) the
+ * consumer's head node are no longer being read. */
+static ulist_node_t *_producer_get_node(ulist_spsc_t *queue)
+{
+    ulist_node_t *node;
+
+    if (queue->first == queue->head_copy)
+    {
+        queue->head_copy = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    }
+
+    if (queue->first != queue->head_copy)
+    {
+        node = queue->first;
+        queue->first = node->next;
+    }
+    else if ((node = _alloc_node(&queue->list)) == NULL)
+    {
+        return NULL;
+    }
+    else
+    {
+        queue->list.nodes += 1u;
+    }
+
+    node->next = NULL;
+    node->previous = NULL;
+    node->used = 0u;
+    return node;
+}
+
+
+/**
+ * @see ulist_spsc_api.h
+ */
+ulist_status_e ulist_spsc_create(ulist_spsc_t *queue, size_t item_size_bytes,
+    size_t items_per_node)
+{
+    if (NULL == queue)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_status_e err = ulist_create(&queue->list, item_size_bytes,
+                                      items_per_node);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    queue->first = queue->list.head;
+    queue->head_copy = queue->list.head;
+    queue->head = queue->list.head;
+    queue->read_index = 0u;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_spsc_api.h
+ */
+ulist_status_e ulist_spsc_destroy(ulist_spsc_t *queue)
+{
+    if (NULL == queue)
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    // Nodes waiting to be reused are still connected in front of the head
+    queue->list.head = queue->first;
+    return ulist_destroy(&queue->list);
+}
+
+
+/**
+ * @see ulist_spsc_api.h
+ */
+ulist_status_e ulist_spsc_push(ulist_spsc_t *queue, void *item)
+{
+    if ((NULL == queue) || (NULL == queue->list.tail) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_t *list = &queue->list;
+    ulist_node_t *tail = list->tail;
+
+    // Tail node is full, connect a new one
+    if (tail->used == tail->capacity)
+    {
+        ulist_node_t *new;
+
+        if ((new = _producer_get_node(queue)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        new->previous = tail;
+        __atomic_store_n(&tail->next, new, __ATOMIC_RELEASE);
+        list->tail = new;
+        tail = new;
+    }
+
+    memcpy(NODE_DATA(list, tail, tail->used), item, list->item_size_bytes);
+
+    // Publish the item to the consumer
+    __atomic_store_n(&tail->used, tail->used + 1u, __ATOMIC_RELEASE);
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_spsc_api.h
+ */
+ulist_status_e ulist_spsc_pop(ulist_spsc_t *queue, void *item)
+{
+    if ((NULL == queue) || (NULL == queue->list.head) || (NULL == item))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    ulist_t *list = &queue->list;
+    ulist_node_t *head = queue->head;
+
+    // Finished with this node-- the producer only moves on from full nodes
+    if (queue->read_index == head->capacity)
+    {
+        ulist_node_t *next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+
+        if (NULL == next)
+        {
+            return ULIST_END;
+        }
+
+        // Hand the finished node back to the producer
+        __atomic_store_n(&queue->head, next, __ATOMIC_RELEASE);
+        queue->read_index = 0u;
+        head = next;
+    }
+
+    if (queue->read_index == __atomic_load_n(&head->used, __ATOMIC_ACQUIRE))
+    {
+        return ULIST_END;
+    }
+
+    memcpy(item, NODE_DATA(list, head, queue->read_index),
+           list->item_size_bytes);
+    queue->read_index += 1u;
+    return ULIST_OK;
+}
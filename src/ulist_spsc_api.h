@@ -0,0 +1,87 @@
+/**
+ * @file   ulist_spsc_api.h
+ * @author Erik Nyquist
+ * @brief  Lock-free single-producer/single-consumer queue built on ulist nodes
+ *
+ * A FIFO queue for passing items from exactly one producer thread to exactly
+ * one consumer thread without locking. The producer fills the tail node and
+ * the consumer drains the head node; the number of items written to a node
+ * (node->used) and the link to the next node are published with atomic
+ * stores, so the consumer never reads an item before it has been written.
+ *
+ * Nodes that the consumer has finished with are not freed. The producer keeps
+ * a pointer to the oldest node in the chain, and every node between that and
+ * the consumer's current node can be reused for new items, so a queue that
+ * has reached its working size stops allocating.
+ */
+#ifndef ULIST_SPSC_API_H
+#define ULIST_SPSC_API_H
+
+#include "ulist_api.h"
+
+
+/* Single SPSC queue instance. Fields in the first group are only touched by
+ * the producer, and fields in the second group by the consumer, except where
+ * noted. */
+typedef struct {
+    ulist_t list;             // Node parameters. list.tail and list.nodes are
+                              // owned by the producer, nothing else is used
+    ulist_node_t *first;      // Oldest node, which may be free for reuse
+    ulist_node_t *head_copy;  // Producer's last seen value of head
+
+    _Alignas(ULIST_CACHE_LINE_BYTES)
+    ulist_node_t *head;       // Node being drained. Read by the producer
+    size_t read_index;        // Index of the next item to read in head
+} ulist_spsc_t;
+
+
+/**
+ * Initialize a queue instance.
+ *
+ * @param    queue           Uninitialized queue structure to initialize
+ * @param    item_size_bytes Size of a single item in bytes
+ * @Param    items_per_node  Number of items that each node should hold
+ *
+ * @return   ULIST_OK        If queue instance was initialized successfully
+ */
+ulist_status_e ulist_spsc_create(ulist_spsc_t *queue, size_t item_size_bytes,
+    size_t items_per_node);
+
+
+/**
+ * Destroy an initialized queue instance. Neither the producer nor the
+ * consumer may be using the queue when this is called.
+ *
+ * @param    queue           Queue instance to destroy
+ *
+ * @return   ULIST_OK        If queue instance was destroyed successfully
+ */
+ulist_status_e ulist_spsc_destroy(ulist_spsc_t *queue);
+
+
+/**
+ * Add an item to the end of the queue. Must only be called from the producer
+ * thread.
+ *
+ * @param    queue           Queue instance
+ * @param    item            Pointer to item data to add
+ *
+ * @return   ULIST_OK        If item was added successfully
+ */
+ulist_status_e ulist_spsc_push(ulist_spsc_t *queue, void *item);
+
+
+/**
+ * Remove the item at the front of the queue. Must only be called from the
+ * consumer thread.
+ *
+ * @param    queue           Queue instance
+ * @param    item            Pointer to copy item data to
+ *
+ * @return   ULIST_OK        If an item was removed successfully, or ULIST_END
+ *                           if the queue is empty
+ */
+ulist_status_e ulist_spsc_pop(ulist_spsc_t *queue, void *item);
+
+
+#endif
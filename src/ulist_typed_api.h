@@ -0,0 +1,202 @@
+/**
+ * @file   ulist_typed_api.h
+ * @author Erik Nyquist
+ * @brief  Code generator for statically typed ulist variants
+ *
+ * ULIST_DEFINE(name, type, items_per_node) emits a list type called name_t
+ * and a set of functions (name_create, name_append, name_get, name_pop...)
+ * that take and return items of the given type by value. The generated
+ * functions are static inline and handle the common cases (appending to a
+ * tail node with space remaining, reading from the head or tail node, popping
+ * the tail item) directly on the node data with the item size and node
+ * capacity known at compile time, so the compiler can inline and vectorize
+ * them per type. Anything that needs nodes to be allocated, balanced, crawled
+ * or copied (when shared with a snapshot or clone) is passed through to the
+ * regular ulist API.
+ *
+ * Example:
+ *
+ *     ULIST_DEFINE(intlist, int, 64u)
+ *
+ *     intlist_t list;
+ *     int value;
+ *
+ *     intlist_create(&list);
+ *     intlist_append(&list, 42);
+ *     intlist_get(&list, 0u, &value);
+ *     intlist_destroy(&list);
+ */
+#ifndef ULIST_TYPED_API_H
+#define ULIST_TYPED_API_H
+
+#include "ulist_api.h"
+
+
+#define ULIST_DEFINE(name, type, items_per_node)                               \
+                                                                               \
+typedef struct {                                                               \
+    ulist_t list;                                                              \
+} name##_t;                                                                    \
+                                                                               \
+static inline type *name##_node_items(ulist_node_t *node)                      \
+{                                                                              \
+    return (type *) node->items;                                               \
+}                                                                              \
+                                                                               \
+/* Shared nodes must be copied before they are modified, spill lists */        \
+/* track which nodes have been modified, and logged lists record it */         \
+static inline int name##_node_writable(name##_t *l, ulist_node_t *node)        \
+{                                                                              \
+    return (NULL == l->list.spill) && (NULL == l->list.wal)                    \
+           && (NULL == l->list.adapt)                                          \
+           && (NULL == node->owner)                                            \
+           && (1u == __atomic_load_n(&node->refs, __ATOMIC_ACQUIRE));          \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_create(name##_t *l)                        \
+{                                                                              \
+    if (NULL == l)                                                             \
+    {                                                                          \
+        return ULIST_INVALID_PARAM;                                            \
+    }                                                                          \
+                                                                               \
+    return ulist_create(&l->list, sizeof(type), (items_per_node));             \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_destroy(name##_t *l)                       \
+{                                                                              \
+    return (NULL == l) ? ULIST_INVALID_PARAM : ulist_destroy(&l->list);        \
+}                                                                              \
+                                                                               \
+static inline unsigned long long name##_size(name##_t *l)                      \
+{                                                                              \
+    return l->list.num_items;                                                  \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_append(name##_t *l, type item)             \
+{                                                                              \
+    if ((NULL == l) || (NULL == l->list.tail))                                 \
+    {                                                                          \
+        return ULIST_INVALID_PARAM;                                            \
+    }                                                                          \
+                                                                               \
+    ulist_node_t *tail = l->list.tail;                                         \
+                                                                               \
+    if ((tail->used < (items_per_node)) && name##_node_writable(l, tail))      \
+    {                                                                          \
+        name##_node_items(tail)[tail->used] = item;                            \
+        tail->used += 1u;                                                      \
+        l->list.num_items += 1u;                                               \
+        return ULIST_OK;                                                       \
+    }                                                                          \
+                                                                               \
+    return ulist_append_item(&l->list, &item);                                 \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_insert(name##_t *l,                        \
+    unsigned long long index, type item)                                       \
+{                                                                              \
+    if (NULL == l)                                                             \
+    {                                                                          \
+        return ULIST_INVALID_PARAM;                                            \
+    }                                                                          \
+                                                                               \
+    if ((NULL != l->list.tail) && (index == l->list.num_items))                \
+    {                                                                          \
+        return name##_append(l, item);                                         \
+    }                                                                          \
+                                                                               \
+    return ulist_insert_item(&l->list, index, &item);                          \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_get(name##_t *l,                           \
+    unsigned long long index, type *item)                                      \
+{                                                                              \
+    if ((NULL == l) || (NULL == item))                                         \
+    {                                                                          \
+        return ULIST_INVALID_PARAM;                                            \
+    }                                                                          \
+                                                                               \
+    /* Mapped, spill and adaptive lists are handled by ulist_get_item */       \
+    if ((NULL == l->list.tail) || (NULL != l->list.spill)                      \
+        || (NULL != l->list.adapt) || (index >= l->list.num_items))            \
+    {                                                                          \
+        return ulist_get_item(&l->list, index, item);                          \
+    }                                                                          \
+                                                                               \
+    ulist_node_t *head = l->list.head;                                         \
+    ulist_node_t *tail = l->list.tail;                                         \
+    unsigned long long tail_start = l->list.num_items - tail->used;            \
+                                                                               \
+    if (index < head->used)                                                    \
+    {                                                                          \
+        *item = name##_node_items(head)[index];                                \
+        return ULIST_OK;                                                       \
+    }                                                                          \
+                                                                               \
+    if (index >= tail_start)                                                   \
+    {                                                                          \
+        *item = name##_node_items(tail)[index - tail_start];                   \
+        return ULIST_OK;                                                       \
+    }                                                                          \
+                                                                               \
+    void *data;                                                                \
+    ulist_status_e err = ulist_get_item_pointer(&l->list, index, &data);       \
+    if (ULIST_OK == err)                                                       \
+    {                                                                          \
+        *item = *(type *) data;                                                \
+    }                                                                          \
+                                                                               \
+    return err;                                                                \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_pop(name##_t *l,                           \
+    unsigned long long index, type *item)                                      \
+{                                                                              \
+    if ((NULL == l) || (NULL == l->list.tail))                                 \
+    {                                                                          \
+        return ULIST_INVALID_PARAM;                                            \
+    }                                                                          \
+                                                                               \
+    ulist_node_t *tail = l->list.tail;                                         \
+                                                                               \
+    /* Popping the tail item doesn't require any items to be moved, and if */  \
+    /* the tail node stays over half full no nodes need to be balanced */      \
+    if ((index < l->list.num_items) && (index == (l->list.num_items - 1u))     \
+        && name##_node_writable(l, tail) && ((tail == l->list.head)            \
+            || ((tail->used - 1u) > ((items_per_node) / 2u))))                 \
+    {                                                                          \
+        tail->used -= 1u;                                                      \
+        l->list.num_items -= 1u;                                               \
+        if (NULL != item)                                                      \
+        {                                                                      \
+            *item = name##_node_items(tail)[tail->used];                       \
+        }                                                                      \
+                                                                               \
+        return ULIST_OK;                                                       \
+    }                                                                          \
+                                                                               \
+    return ulist_pop_item(&l->list, index, item);                              \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_get_next(name##_t *l, type **item)         \
+{                                                                              \
+    return (NULL == l) ? ULIST_INVALID_PARAM                                   \
+                       : ulist_get_next_item(&l->list, (void **) item);        \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_get_previous(name##_t *l, type **item)     \
+{                                                                              \
+    return (NULL == l) ? ULIST_INVALID_PARAM                                   \
+                       : ulist_get_previous_item(&l->list, (void **) item);    \
+}                                                                              \
+                                                                               \
+static inline ulist_status_e name##_set_iteration_start_index(name##_t *l,     \
+    unsigned long long index)                                                  \
+{                                                                              \
+    return (NULL == l) ? ULIST_INVALID_PARAM                                   \
+                       : ulist_set_iteration_start_index(&l->list, index);     \
+}
+
+
+#endif
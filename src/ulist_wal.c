@@ -0,0 +1,620 @@
+/**
+ * @file   ulist_wal.c
+ * @author Erik Nyquist
+ * @brief  ulist backed by a write-ahead log
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ulist_wal_api.h"
+#include "ulist_io_api.h"
+#include "ulist_internal.h"
+
+
+#define WAL_MAGIC (0x4c574c55u)           // "ULWL"
+#define WAL_SNAPSHOT_MAGIC (0x53574c55u)  // "ULWS"
+#define WAL_VERSION (1u)
+
+#define SNAPSHOT_SUFFIX ".snap"
+#define SNAPSHOT_TMP_SUFFIX ".snap.tmp"
+
+
+/* Header at the start of the log file */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t item_size_bytes;
+    uint64_t items_per_node;
+    uint64_t reserved;
+} wal_header_t;
+
+
+/* Header at the start of the snapshot file, followed by ulist_save output */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seq;       // Sequence number of the last record in the snapshot
+} wal_snapshot_header_t;
+
+
+/* Log record, followed by the item for appends and inserts */
+typedef struct {
+    uint32_t checksum;  // Of everything after this field, including the item
+    uint32_t op;
+    uint64_t seq;
+    uint64_t index;
+} wal_record_t;
+
+
+struct ulist_wal {
+    int fd;
+    char *snapshot_path;
+    char *tmp_path;             // Snapshot being written during compaction
+    char *dir_path;             // Directory holding the log and snapshot
+    char *buf;                  // Records not yet written to the log
+    size_t buf_used;
+    size_t buf_size;
+    size_t group_bytes;
+    size_t compact_bytes;
+    unsigned long long log_bytes;   // Size of the log file
+    unsigned long long seq;         // Sequence number of the last record
+};
+
+
+// FNV-1a hash of a record, minus its checksum field
+static uint32_t _checksum(const char *record, size_t size_bytes)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = sizeof(uint32_t); i < size_bytes; i++)
+    {
+        hash = (hash ^ (unsigned char) record[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+// Read or write len bytes, continuing after partial transfers
+static int _transfer(int fd, void *buf, size_t len, int writing)
+{
+    char *pos = buf;
+
+    while (len > 0u)
+    {
+        ssize_t ret = (writing) ? write(fd, pos, len) : read(fd, pos, len);
+
+        if ((ret < 0) && (EINTR == errno))
+        {
+            continue;
+        }
+
+        if (ret <= 0)
+        {
+            return 0;
+        }
+
+        pos += ret;
+        len -= (size_t) ret;
+    }
+
+    return 1;
+}
+
+
+// Check whether the record for an operation is followed by an item
+static int _has_item(uint32_t op)
+{
+    return (WAL_OP_APPEND == op) || (WAL_OP_INSERT == op);
+}
+
+
+// Size of a record for an operation, including the item
+static size_t _record_size(ulist_t *list, uint32_t op)
+{
+    return sizeof(wal_record_t) + (_has_item(op) ? list->item_size_bytes : 0u);
+}
+
+
+// Run a logged operation on a list
+static ulist_status_e _run_op(ulist_t *list, uint32_t op,
+    unsigned long long index, void *item)
+{
+    switch (op)
+    {
+        case WAL_OP_APPEND:
+            return ulist_append_item(list, item);
+        case WAL_OP_INSERT:
+            return ulist_insert_item(list, index, item);
+        case WAL_OP_POP:
+            return ulist_pop_item(list, index, item);
+        default:
+            return ulist_clear(list, index);
+    }
+}
+
+
+// Allocate a copy of path with suffix appended
+static char *_append_suffix(const char *path, const char *suffix)
+{
+    size_t len = strlen(path);
+    char *ret;
+
+    if ((ret = malloc(len + strlen(suffix) + 1u)) != NULL)
+    {
+        memcpy(ret, path, len);
+        strcpy(ret + len, suffix);
+    }
+
+    return ret;
+}
+
+
+// Path of the directory holding a file
+static char *_dir_name(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+
+    if (NULL == slash)
+    {
+        return _append_suffix(".", "");
+    }
+
+    // Keep the slash if the file is in the root directory
+    size_t len = (slash == path) ? 1u : (size_t) (slash - path);
+    char *ret;
+
+    if ((ret = malloc(len + 1u)) != NULL)
+    {
+        memcpy(ret, path, len);
+        ret[len] = '\0';
+    }
+
+    return ret;
+}
+
+
+/* Wait for the entries of the log directory, such as a renamed snapshot, to
+ * reach the disk */
+static ulist_status_e _sync_dir(struct ulist_wal *wal)
+{
+    int fd = open(wal->dir_path, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    int ret = fsync(fd);
+    close(fd);
+    return (0 == ret) ? ULIST_OK : ULIST_ERROR_IO;
+}
+
+
+// Write buffered records to the log, and wait for them to reach the disk
+static ulist_status_e _write_records(struct ulist_wal *wal)
+{
+    if (0u == wal->buf_used)
+    {
+        return ULIST_OK;
+    }
+
+    if (!_transfer(wal->fd, wal->buf, wal->buf_used, 1)
+        || (0 != fdatasync(wal->fd)))
+    {
+        // Cut off any partly written records, so that a retry follows on
+        (void) ftruncate(wal->fd, (off_t) wal->log_bytes);
+        (void) lseek(wal->fd, (off_t) wal->log_bytes, SEEK_SET);
+        return ULIST_ERROR_IO;
+    }
+
+    wal->log_bytes += wal->buf_used;
+    wal->buf_used = 0u;
+    return ULIST_OK;
+}
+
+
+/* Load the snapshot of a log into list, or create an empty list if there is
+ * no snapshot yet, and set *seq to the last record the snapshot contains */
+static ulist_status_e _load_snapshot(struct ulist_wal *wal, ulist_t *list,
+    size_t item_size_bytes, size_t items_per_node, unsigned long long *seq)
+{
+    int fd = open(wal->snapshot_path, O_RDONLY);
+    if (fd < 0)
+    {
+        *seq = 0u;
+        return (ENOENT == errno)
+               ? ulist_create(list, item_size_bytes, items_per_node)
+               : ULIST_ERROR_IO;
+    }
+
+    wal_snapshot_header_t header;
+    ulist_status_e err = ULIST_ERROR_FORMAT;
+
+    if (_transfer(fd, &header, sizeof(header), 0)
+        && (WAL_SNAPSHOT_MAGIC == header.magic)
+        && (WAL_VERSION == header.version))
+    {
+        err = ulist_load(list, fd);
+    }
+
+    close(fd);
+
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    if ((item_size_bytes != list->item_size_bytes)
+        || (items_per_node != list->items_per_node))
+    {
+        (void) ulist_destroy(list);
+        return ULIST_ERROR_FORMAT;
+    }
+
+    *seq = header.seq;
+    return ULIST_OK;
+}
+
+
+/* Apply the records of a log that came after the snapshot to list, stopping
+ * at the first record that is incomplete or damaged. The log is cut off
+ * after the last good record. */
+static ulist_status_e _replay(struct ulist_wal *wal, ulist_t *list)
+{
+    struct stat st;
+
+    if (0 != fstat(wal->fd, &st))
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    size_t size = (size_t) st.st_size;
+
+    if (size < sizeof(wal_header_t))
+    {
+        // Log was never written past its header
+        wal_header_t header;
+        memset(&header, 0, sizeof(header));
+        header.magic = WAL_MAGIC;
+        header.version = WAL_VERSION;
+        header.item_size_bytes = list->item_size_bytes;
+        header.items_per_node = list->items_per_node;
+
+        if ((0 != ftruncate(wal->fd, 0))
+            || !_transfer(wal->fd, &header, sizeof(header), 1)
+            || (0 != fdatasync(wal->fd)))
+        {
+            return ULIST_ERROR_IO;
+        }
+
+        wal->log_bytes = sizeof(header);
+        return ULIST_OK;
+    }
+
+    char *log = mmap(NULL, size, PROT_READ, MAP_SHARED, wal->fd, 0);
+    if (MAP_FAILED == log)
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    wal_header_t *header = (wal_header_t *) log;
+
+    if ((WAL_MAGIC != header->magic) || (WAL_VERSION != header->version)
+        || (list->item_size_bytes != header->item_size_bytes)
+        || (list->items_per_node != header->items_per_node))
+    {
+        munmap(log, size);
+        return ULIST_ERROR_FORMAT;
+    }
+
+    size_t pos = sizeof(wal_header_t);
+    ulist_status_e err = ULIST_OK;
+
+    while ((ULIST_OK == err) && ((size - pos) >= sizeof(wal_record_t)))
+    {
+        wal_record_t record;
+        memcpy(&record, log + pos, sizeof(record));
+
+        if ((record.op < WAL_OP_APPEND) || (record.op > WAL_OP_CLEAR))
+        {
+            break;
+        }
+
+        size_t record_size = _record_size(list, record.op);
+
+        if (((size - pos) < record_size)
+            || (_checksum(log + pos, record_size) != record.checksum)
+            || (record.seq > (wal->seq + 1u)))
+        {
+            break;
+        }
+
+        // Records up to wal->seq are already part of the snapshot
+        if (record.seq == (wal->seq + 1u))
+        {
+            void *item = _has_item(record.op) ? log + pos + sizeof(record)
+                                              : NULL;
+
+            err = _run_op(list, record.op, record.index, item);
+            wal->seq = record.seq;
+        }
+
+        pos += record_size;
+    }
+
+    munmap(log, size);
+
+    if (ULIST_ERROR_MEM == err)
+    {
+        return err;
+    }
+
+    if (ULIST_OK != err)
+    {
+        // Record doesn't fit the list it was made for
+        return ULIST_ERROR_FORMAT;
+    }
+
+    if (((pos < size) && (0 != ftruncate(wal->fd, (off_t) pos)))
+        || (lseek(wal->fd, (off_t) pos, SEEK_SET) < 0))
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    wal->log_bytes = pos;
+    return ULIST_OK;
+}
+
+
+static void _free_wal(struct ulist_wal *wal)
+{
+    if (wal->fd >= 0)
+    {
+        close(wal->fd);
+    }
+
+    free(wal->buf);
+    free(wal->snapshot_path);
+    free(wal->tmp_path);
+    free(wal->dir_path);
+    free(wal);
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+ulist_status_e _wal_apply(ulist_t *list, wal_op_e op, unsigned long long index,
+    void *item)
+{
+    struct ulist_wal *wal = list->wal;
+    size_t record_size = _record_size(list, op);
+
+    // Make room first, so that every successful operation gets its record
+    if ((wal->buf_used + record_size) > wal->buf_size)
+    {
+        size_t new_size = MAX(wal->buf_used + record_size, wal->buf_size * 2u);
+        char *buf;
+
+        if ((buf = realloc(wal->buf, new_size)) == NULL)
+        {
+            return ULIST_ERROR_MEM;
+        }
+
+        wal->buf = buf;
+        wal->buf_size = new_size;
+    }
+
+    list->wal = NULL;
+    ulist_status_e err = _run_op(list, op, index, item);
+    list->wal = wal;
+
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    char *dest = wal->buf + wal->buf_used;
+    wal_record_t record;
+
+    record.checksum = 0u;
+    record.op = op;
+    record.seq = ++wal->seq;
+    record.index = index;
+
+    memcpy(dest, &record, sizeof(record));
+
+    if (_has_item(op))
+    {
+        memcpy(dest + sizeof(record), item, list->item_size_bytes);
+    }
+
+    record.checksum = _checksum(dest, record_size);
+    memcpy(dest, &record.checksum, sizeof(record.checksum));
+    wal->buf_used += record_size;
+
+    if (wal->buf_used < wal->group_bytes)
+    {
+        return ULIST_OK;
+    }
+
+    // The operation stays done either way; its record is written out later
+    if (ULIST_OK != _write_records(wal))
+    {
+        return ULIST_NOT_DURABLE;
+    }
+
+    /* The records are on disk, and a failed compaction leaves a recoverable
+     * log, so it is just tried again after the next write */
+    if ((0u != wal->compact_bytes) && (wal->log_bytes >= wal->compact_bytes))
+    {
+        (void) ulist_wal_compact(list);
+    }
+
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_internal.h
+ */
+ulist_status_e _wal_close(ulist_t *list)
+{
+    ulist_status_e err = _write_records(list->wal);
+
+    _free_wal(list->wal);
+    list->wal = NULL;
+    return err;
+}
+
+
+/**
+ * @see ulist_wal_api.h
+ */
+ulist_status_e ulist_wal_open(ulist_t *list, const char *path,
+    size_t item_size_bytes, size_t items_per_node, size_t group_bytes,
+    size_t compact_bytes)
+{
+    if ((NULL == list) || (NULL == path))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    struct ulist_wal *wal;
+
+    if ((wal = calloc(1u, sizeof(struct ulist_wal))) == NULL)
+    {
+        return ULIST_ERROR_MEM;
+    }
+
+    wal->fd = -1;
+    wal->group_bytes = group_bytes;
+    wal->compact_bytes = compact_bytes;
+    wal->snapshot_path = _append_suffix(path, SNAPSHOT_SUFFIX);
+    wal->tmp_path = _append_suffix(path, SNAPSHOT_TMP_SUFFIX);
+    wal->dir_path = _dir_name(path);
+
+    if ((NULL == wal->snapshot_path) || (NULL == wal->tmp_path)
+        || (NULL == wal->dir_path))
+    {
+        _free_wal(wal);
+        return ULIST_ERROR_MEM;
+    }
+
+    ulist_status_e err = _load_snapshot(wal, list, item_size_bytes,
+                                        items_per_node, &wal->seq);
+    if (ULIST_OK != err)
+    {
+        _free_wal(wal);
+        return err;
+    }
+
+    if ((wal->fd = open(path, O_RDWR | O_CREAT, 0644)) < 0)
+    {
+        err = ULIST_ERROR_IO;
+    }
+    else
+    {
+        err = _replay(wal, list);
+    }
+
+    if (ULIST_OK != err)
+    {
+        (void) ulist_destroy(list);
+        _free_wal(wal);
+        return err;
+    }
+
+    list->wal = wal;
+    return ULIST_OK;
+}
+
+
+/**
+ * @see ulist_wal_api.h
+ */
+ulist_status_e ulist_wal_sync(ulist_t *list)
+{
+    if ((NULL == list) || (NULL == list->wal))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    struct ulist_wal *wal = list->wal;
+    ulist_status_e err = _write_records(wal);
+
+    if ((ULIST_OK == err) && (0u != wal->compact_bytes)
+        && (wal->log_bytes >= wal->compact_bytes))
+    {
+        err = ulist_wal_compact(list);
+    }
+
+    return err;
+}
+
+
+/**
+ * @see ulist_wal_api.h
+ */
+ulist_status_e ulist_wal_compact(ulist_t *list)
+{
+    if ((NULL == list) || (NULL == list->wal))
+    {
+        return ULIST_INVALID_PARAM;
+    }
+
+    struct ulist_wal *wal = list->wal;
+    ulist_status_e err = _write_records(wal);
+    if (ULIST_OK != err)
+    {
+        return err;
+    }
+
+    wal_snapshot_header_t header;
+    header.magic = WAL_SNAPSHOT_MAGIC;
+    header.version = WAL_VERSION;
+    header.seq = wal->seq;
+
+    int fd = open(wal->tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    if (!_transfer(fd, &header, sizeof(header), 1))
+    {
+        err = ULIST_ERROR_IO;
+    }
+    else if ((err = ulist_save(list, fd)) == ULIST_OK)
+    {
+        err = (0 == fsync(fd)) ? ULIST_OK : ULIST_ERROR_IO;
+    }
+
+    close(fd);
+
+    if (ULIST_OK != err)
+    {
+        (void) unlink(wal->tmp_path);
+        return err;
+    }
+
+    /* Records up to header.seq are skipped if the log is not emptied after
+     * this. The rename must reach the disk before the log is emptied, or a
+     * crash could leave the old snapshot next to an empty log. */
+    if ((0 != rename(wal->tmp_path, wal->snapshot_path))
+        || (ULIST_OK != _sync_dir(wal))
+        || (0 != ftruncate(wal->fd, sizeof(wal_header_t)))
+        || (lseek(wal->fd, sizeof(wal_header_t), SEEK_SET) < 0)
+        || (0 != fdatasync(wal->fd)))
+    {
+        return ULIST_ERROR_IO;
+    }
+
+    wal->log_bytes = sizeof(wal_header_t);
+    return ULIST_OK;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file   ulist_wal_api.h
+ * @author Erik Nyquist
+ * @brief  ulist backed by a write-ahead log, for recovery after restarts
+ *
+ * A logged list works like a regular list, but every successful
+ * #ulist_append_item, #ulist_insert_item, #ulist_pop_item and #ulist_clear
+ * also adds a small record (operation, index and item) to a log file. Records
+ * are buffered, and written out with a single write and fdatasync once enough
+ * of them have built up (group commit), when #ulist_wal_sync is called, or
+ * when the list is destroyed. Operations whose records have not been written
+ * out yet are lost if the process dies.
+ *
+ * If writing out the records fails during one of those operations, the
+ * operation itself has still been done, and it returns ULIST_NOT_DURABLE
+ * instead of ULIST_OK. Its record stays buffered, and is written out by the
+ * next successful write, such as a call to #ulist_wal_sync.
+ *
+ * #ulist_wal_open rebuilds the list by loading the latest snapshot and
+ * replaying the log records that came after it. Each record carries a
+ * sequence number and a checksum, so a record that was only partly written
+ * when the process died is detected and cut off the end of the log.
+ *
+ * Compaction writes the whole list as a snapshot, in the format used by
+ * #ulist_save, and empties the log. The snapshot is written to a temporary
+ * file and renamed into place before the log is emptied, and records that
+ * are already part of the snapshot are skipped during recovery, so a crash at
+ * any point during compaction leaves a recoverable list.
+ *
+ * The log is stored at the given path, and the snapshot at the same path with
+ * ".snap" appended. Only one list instance may use a log at a time.
+ */
+#ifndef ULIST_WAL_API_H
+#define ULIST_WAL_API_H
+
+#include "ulist_api.h"
+
+
+/**
+ * Initialize a list instance from a log and snapshot, creating an empty log
+ * if there is none yet. Close the log by destroying the list with
+ * #ulist_destroy.
+ *
+ * @param    list            Uninitialized list structure to initialize
+ * @param    path            Path of the log file
+ * @param    item_size_bytes Size of a single list item in bytes
+ * @Param    items_per_node  Number of items that each list node should hold
+ * @param    group_bytes     Number of bytes of records to buffer before
+ *                           writing them out. 0 writes out each record as
+ *                           soon as it is made.
+ * @param    compact_bytes   Log size at which the list is compacted after
+ *                           writing out records. 0 disables automatic
+ *                           compaction.
+ *
+ * @return   ULIST_OK            If list instance was initialized successfully
+ * @return   ULIST_ERROR_IO      If the log or snapshot could not be opened,
+ *                               read or written
+ * @return   ULIST_ERROR_FORMAT  If the log or snapshot is invalid, or was
+ *                               made for a different item size or node size
+ */
+ulist_status_e ulist_wal_open(ulist_t *list, const char *path,
+    size_t item_size_bytes, size_t items_per_node, size_t group_bytes,
+    size_t compact_bytes);
+
+
+/**
+ * Write out all buffered log records, and wait for them to reach the disk.
+ *
+ * @param    list            List instance opened with #ulist_wal_open
+ *
+ * @return   ULIST_OK        If all records were written successfully
+ * @return   ULIST_ERROR_IO  If writing the log failed
+ */
+ulist_status_e ulist_wal_sync(ulist_t *list);
+
+
+/**
+ * Write the whole list to the snapshot file and empty the log.
+ *
+ * @param    list            List instance opened with #ulist_wal_open
+ *
+ * @return   ULIST_OK        If the list was compacted successfully
+ * @return   ULIST_ERROR_IO  If writing the snapshot or log failed
+ */
+ulist_status_e ulist_wal_compact(ulist_t *list);
+
+
+#endif
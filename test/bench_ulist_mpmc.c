@@ -0,0 +1,148 @@
+/**
+ * Throughput benchmark for the MPMC queue. The same number of items is passed
+ * from N producer threads to N consumer threads, once through a ulist guarded
+ * by a mutex (#ulist_append_item to push, #ulist_pop_item at index 0 to pop)
+ * and once through a #ulist_mpmc_t, and the results are printed as CSV.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "ulist_mpmc_api.h"
+
+#define ITEMS_PER_NODE     (64u)
+#define ITEMS_PER_PRODUCER (200000u)
+#define MAX_PAIRS          (4u)
+
+typedef enum {
+    QUEUE_MUTEX,
+    QUEUE_MPMC
+} queue_type_e;
+
+typedef struct {
+    queue_type_e type;
+    unsigned int id;
+    unsigned long long checksum;
+} thread_args_t;
+
+static ulist_t _list;
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+static ulist_mpmc_t _queue;
+static unsigned long long _remaining;
+
+
+static double _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+
+static void *_producer(void *arg)
+{
+    thread_args_t *args = (thread_args_t *) arg;
+
+    for (unsigned long long i = 0u; i < ITEMS_PER_PRODUCER; i++)
+    {
+        if (QUEUE_MUTEX == args->type)
+        {
+            pthread_mutex_lock(&_mutex);
+            (void) ulist_append_item(&_list, &i);
+            pthread_mutex_unlock(&_mutex);
+        }
+        else
+        {
+            (void) ulist_mpmc_push(&_queue, args->id, &i);
+        }
+    }
+
+    return NULL;
+}
+
+
+static void *_consumer(void *arg)
+{
+    thread_args_t *args = (thread_args_t *) arg;
+
+    while (__atomic_load_n(&_remaining, __ATOMIC_RELAXED) > 0u)
+    {
+        unsigned long long val;
+        ulist_status_e err;
+
+        if (QUEUE_MUTEX == args->type)
+        {
+            pthread_mutex_lock(&_mutex);
+            err = ulist_pop_item(&_list, 0u, &val);
+            pthread_mutex_unlock(&_mutex);
+        }
+        else
+        {
+            err = ulist_mpmc_pop(&_queue, args->id, &val);
+        }
+
+        if (ULIST_OK == err)
+        {
+            args->checksum += val;
+            __atomic_sub_fetch(&_remaining, 1u, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+
+static void _run(queue_type_e type, unsigned int pairs)
+{
+    pthread_t threads[MAX_PAIRS * 2u];
+    thread_args_t args[MAX_PAIRS * 2u];
+    unsigned long long checksum = 0u;
+
+    ulist_create(&_list, sizeof(unsigned long long), ITEMS_PER_NODE);
+    ulist_mpmc_create(&_queue, sizeof(unsigned long long), ITEMS_PER_NODE,
+                      pairs * 2u);
+    _remaining = (unsigned long long) ITEMS_PER_PRODUCER * pairs;
+
+    double start = _now_ns();
+
+    for (unsigned i = 0u; i < (pairs * 2u); i++)
+    {
+        args[i].type = type;
+        args[i].id = i;
+        args[i].checksum = 0u;
+        pthread_create(&threads[i], NULL, (i < pairs) ? _producer : _consumer,
+                       &args[i]);
+    }
+
+    for (unsigned i = 0u; i < (pairs * 2u); i++)
+    {
+        pthread_join(threads[i], NULL);
+        checksum += args[i].checksum;
+    }
+
+    double elapsed = _now_ns() - start;
+    double total_ops = (double) ITEMS_PER_PRODUCER * pairs;
+
+    printf("%s,%u,%u,%.0f,%.2f,%.3f,%llu\n",
+           (QUEUE_MUTEX == type) ? "mutex_ulist" : "mpmc", pairs, pairs,
+           total_ops, elapsed / total_ops, (total_ops / elapsed) * 1e3,
+           checksum);
+
+    ulist_mpmc_destroy(&_queue);
+    ulist_destroy(&_list);
+}
+
+
+int main(void)
+{
+    printf("queue,producers,consumers,items,ns_per_item,mitems_per_sec,checksum\n");
+
+    for (unsigned int pairs = 1u; pairs <= MAX_PAIRS; pairs *= 2u)
+    {
+        _run(QUEUE_MUTEX, pairs);
+        _run(QUEUE_MPMC, pairs);
+    }
+
+    return 0;
+}
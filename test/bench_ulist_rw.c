@@ -0,0 +1,123 @@
+/**
+ * Read scaling benchmark for the reader-writer locked ulist wrapper. Several
+ * reader threads fetch random items from the same list, once with every read
+ * serialized by a mutex around #ulist_get_item and once using
+ * #ulist_rw_get_item, and the aggregate throughput is printed as CSV.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "ulist_rw_api.h"
+
+#define NUM_ITEMS       (100000u)
+#define ITEMS_PER_NODE  (64u)
+#define READS_PER_THREAD (200000u)
+#define MAX_THREADS     (16u)
+
+typedef enum {
+    LOCK_MUTEX,
+    LOCK_RWLOCK
+} lock_type_e;
+
+typedef struct {
+    lock_type_e type;
+    unsigned int seed;
+    unsigned long long checksum;
+} reader_args_t;
+
+static ulist_rw_t _rw;
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static double _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+
+static void *_reader(void *arg)
+{
+    reader_args_t *args = (reader_args_t *) arg;
+
+    for (unsigned i = 0u; i < READS_PER_THREAD; i++)
+    {
+        unsigned long long index = rand_r(&args->seed) % NUM_ITEMS;
+        unsigned int val = 0u;
+
+        if (LOCK_MUTEX == args->type)
+        {
+            pthread_mutex_lock(&_mutex);
+            (void) ulist_get_item(&_rw.list, index, &val);
+            pthread_mutex_unlock(&_mutex);
+        }
+        else
+        {
+            (void) ulist_rw_get_item(&_rw, index, &val);
+        }
+
+        args->checksum += val;
+    }
+
+    return NULL;
+}
+
+
+static void _run(lock_type_e type, unsigned int nthreads)
+{
+    pthread_t threads[MAX_THREADS];
+    reader_args_t args[MAX_THREADS];
+    unsigned long long checksum = 0u;
+
+    double start = _now_ns();
+
+    for (unsigned i = 0u; i < nthreads; i++)
+    {
+        args[i].type = type;
+        args[i].seed = i + 1u;
+        args[i].checksum = 0u;
+        pthread_create(&threads[i], NULL, _reader, &args[i]);
+    }
+
+    for (unsigned i = 0u; i < nthreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+        checksum += args[i].checksum;
+    }
+
+    double elapsed = _now_ns() - start;
+    double total_ops = (double) READS_PER_THREAD * nthreads;
+
+    printf("%s,%u,%.0f,%.2f,%.3f,%llu\n",
+           (LOCK_MUTEX == type) ? "mutex" : "rwlock", nthreads, total_ops,
+           elapsed / total_ops, (total_ops / elapsed) * 1e3, checksum);
+}
+
+
+int main(void)
+{
+    if (ULIST_OK != ulist_rw_create(&_rw, sizeof(unsigned int), ITEMS_PER_NODE))
+    {
+        fprintf(stderr, "failed to create list\n");
+        return 1;
+    }
+
+    for (unsigned int i = 0u; i < NUM_ITEMS; i++)
+    {
+        ulist_rw_append_item(&_rw, &i);
+    }
+
+    printf("lock,threads,ops,ns_per_op,mops_per_sec,checksum\n");
+
+    for (unsigned int nthreads = 1u; nthreads <= MAX_THREADS; nthreads *= 2u)
+    {
+        _run(LOCK_MUTEX, nthreads);
+        _run(LOCK_RWLOCK, nthreads);
+    }
+
+    ulist_rw_destroy(&_rw);
+    return 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * Benchmark suite for the core ulist operations, built as test_main. Each
+ * operation is timed across a grid of item sizes and items-per-node values,
+ * and the time and number of heap allocations per operation are printed as
+ * CSV. Allocations are counted by wrapping the allocator functions at link
+ * time (-Wl,--wrap), so only allocations made by ulist itself are counted.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ulist_api.h"
+
+#define NUM_ITEMS       (20000u)
+#define MAX_ITEM_SIZE   (256u)
+
+typedef enum {
+    OP_APPEND,
+    OP_PREPEND,
+    OP_GET_RANDOM,
+    OP_INSERT_RANDOM,
+    OP_POP_RANDOM,
+    OP_ITERATE_FORWARD,
+    OP_ITERATE_BACKWARD,
+    OP_SET_ITERATION_INDEX,
+    NUM_OPS
+} op_e;
+
+static const char *_op_names[NUM_OPS] = {
+    "append", "prepend", "get_random", "insert_random", "pop_random",
+    "iterate_forward", "iterate_backward", "set_iteration_index"
+};
+
+static const size_t _item_sizes[] = {4u, 16u, 64u, 256u};
+static const size_t _items_per_node[] = {8u, 32u, 128u, 512u};
+
+static unsigned long long _allocs;
+static unsigned long long _indices[NUM_ITEMS];
+static char _item[MAX_ITEM_SIZE];
+static volatile char _sink;
+
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_aligned_alloc(size_t alignment, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    _allocs += 1u;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+    _allocs += 1u;
+    return __real_calloc(num, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    _allocs += 1u;
+    return __real_realloc(ptr, size);
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size)
+{
+    _allocs += 1u;
+    return __real_aligned_alloc(alignment, size);
+}
+
+
+static double _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+
+static void _fill(ulist_t *list, unsigned long long num_items)
+{
+    for (unsigned long long i = 0u; i < num_items; i++)
+    {
+        memcpy(_item, &i, sizeof(i));
+        (void) ulist_append_item(list, _item);
+    }
+}
+
+
+/* Random indices for ops that change the list size as they go; each index is
+ * valid for the list size at the point it is used */
+static void _make_indices(op_e op)
+{
+    for (unsigned long long i = 0u; i < NUM_ITEMS; i++)
+    {
+        unsigned long long size = (OP_INSERT_RANDOM == op) ? i + 1u
+                                : (OP_POP_RANDOM == op) ? NUM_ITEMS - i
+                                : NUM_ITEMS;
+        _indices[i] = (unsigned long long) rand() % size;
+    }
+}
+
+
+// Iterate over a full list in one direction, and return the time taken in ns
+static double _run_iterate(ulist_t *list, op_e op)
+{
+    ulist_iter_t iter;
+    const void *item;
+    unsigned long long index = (OP_ITERATE_FORWARD == op) ? 0u
+                               : NUM_ITEMS - 1u;
+
+    (void) ulist_iter_init(list, &iter, index);
+
+    double start = _now_ns();
+    ulist_status_e status = ULIST_OK;
+
+    // Stop at the end of the list, or on any error
+    while (ULIST_OK == status)
+    {
+        status = (OP_ITERATE_FORWARD == op) ? ulist_iter_next(&iter, &item)
+                                            : ulist_iter_previous(&iter, &item);
+
+        if (ULIST_OK == status)
+        {
+            _sink = *(const char *) item;
+        }
+    }
+
+    return _now_ns() - start;
+}
+
+
+// Run NUM_ITEMS operations of one kind, and return the time taken in ns
+static double _run_op(ulist_t *list, op_e op)
+{
+    if ((OP_ITERATE_FORWARD == op) || (OP_ITERATE_BACKWARD == op))
+    {
+        return _run_iterate(list, op);
+    }
+
+    double start = _now_ns();
+
+    for (unsigned long long i = 0u; i < NUM_ITEMS; i++)
+    {
+        switch (op)
+        {
+            case OP_APPEND:
+                (void) ulist_append_item(list, _item);
+                break;
+            case OP_PREPEND:
+                (void) ulist_insert_item(list, 0u, _item);
+                break;
+            case OP_GET_RANDOM:
+                (void) ulist_get_item(list, _indices[i], _item);
+                break;
+            case OP_INSERT_RANDOM:
+                (void) ulist_insert_item(list, _indices[i], _item);
+                break;
+            case OP_POP_RANDOM:
+                (void) ulist_pop_item(list, _indices[i], _item);
+                break;
+            default:
+                (void) ulist_set_iteration_start_index(list, _indices[i]);
+                break;
+        }
+    }
+
+    return _now_ns() - start;
+}
+
+
+static int _bench(op_e op, size_t item_size, size_t items_per_node)
+{
+    ulist_t list;
+
+    if (ULIST_OK != ulist_create(&list, item_size, items_per_node))
+    {
+        fprintf(stderr, "failed to create list\n");
+        return -1;
+    }
+
+    // Ops that read or remove items start with a full list
+    if ((OP_APPEND != op) && (OP_PREPEND != op) && (OP_INSERT_RANDOM != op))
+    {
+        _fill(&list, NUM_ITEMS);
+    }
+
+    _make_indices(op);
+
+    unsigned long long allocs = _allocs;
+    double elapsed = _run_op(&list, op);
+    allocs = _allocs - allocs;
+
+    printf("%s,%zu,%zu,%u,%.2f,%.4f\n", _op_names[op], item_size,
+           items_per_node, NUM_ITEMS, elapsed / NUM_ITEMS,
+           (double) allocs / NUM_ITEMS);
+
+    (void) ulist_destroy(&list);
+    return 0;
+}
+
+
+int main(void)
+{
+    srand(1u);
+    printf("op,item_size,items_per_node,ops,ns_per_op,allocs_per_op\n");
+
+    for (op_e op = 0; op < NUM_OPS; op++)
+    {
+        for (size_t i = 0u; i < (sizeof(_item_sizes) / sizeof(size_t)); i++)
+        {
+            for (size_t j = 0u; j < (sizeof(_items_per_node) / sizeof(size_t));
+                 j++)
+            {
+                if (0 != _bench(op, _item_sizes[i], _items_per_node[j]))
+                {
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
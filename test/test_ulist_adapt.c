@@ -0,0 +1,152 @@
+#include <stdlib.h>
+#include "unity.h"
+
+#include "ulist_api.h"
+#include "ulist_adapt_api.h"
+
+#define NODE_SIZE (16u)
+#define NUM_ITEMS (20000u)
+
+static ulist_t list;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK,
+                     ulist_create(&list, sizeof(unsigned), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _fill(unsigned num_items)
+{
+    for (unsigned i = 0u; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+}
+
+void test_ulist_adapt_invalid_params(void)
+{
+    ulist_adapt_stats_t stats;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_adapt_enable(NULL, 4u, 64u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_adapt_enable(&list, 1u, 64u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_adapt_enable(&list, 64u, 4u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_adapt_disable(NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_adapt_get_stats(&list, &stats));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_enable(&list, 4u, 64u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_adapt_get_stats(&list, NULL));
+}
+
+void test_ulist_adapt_grows_for_lookups(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_enable(&list, 4u, 1024u));
+    _fill(NUM_ITEMS);
+
+    // Mostly random reads, with the odd write to trigger evaluation
+    for (unsigned i = 0u; i < (4u * NUM_ITEMS); i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, rand() % NUM_ITEMS,
+                                                   &item));
+
+        if (0u == (i % 64u))
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &item));
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list,
+                                                       list.num_items - 1u,
+                                                       &item));
+        }
+    }
+
+    ulist_adapt_stats_t stats;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_get_stats(&list, &stats));
+    TEST_ASSERT_TRUE(stats.rebuilds >= 1u);
+    TEST_ASSERT_TRUE(list.items_per_node > NODE_SIZE);
+    TEST_ASSERT_EQUAL(NUM_ITEMS, list.num_items);
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &item));
+        TEST_ASSERT_EQUAL(i, item);
+    }
+}
+
+void test_ulist_adapt_shrinks_for_shifts(void)
+{
+    ulist_t big;
+    char item[512];
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&big, sizeof(item), 256u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_enable(&big, 4u, 256u));
+
+    for (unsigned i = 0u; i < 2048u; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&big, item));
+    }
+
+    // Inserts and pops in the middle of the list
+    for (unsigned i = 0u; i < 4096u; i++)
+    {
+        unsigned long long index = 1u + (rand() % (big.num_items - 2u));
+
+        if (i & 1u)
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&big, index, item));
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&big, index, item));
+        }
+    }
+
+    ulist_adapt_stats_t stats;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_get_stats(&big, &stats));
+    TEST_ASSERT_TRUE(stats.rebuilds >= 1u);
+    TEST_ASSERT_TRUE(big.items_per_node < 256u);
+    TEST_ASSERT_EQUAL(2048u, big.num_items);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&big));
+}
+
+void test_ulist_adapt_keeps_order(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_enable(&list, 2u, 2u));
+    _fill(3000u);
+
+    // Forced down to the minimum node size on the first evaluation
+    TEST_ASSERT_EQUAL(2u, list.items_per_node);
+    TEST_ASSERT_EQUAL(1500u, list.nodes);
+
+    for (unsigned i = 0u; i < 3000u; i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &item));
+        TEST_ASSERT_EQUAL(i, item);
+    }
+}
+
+void test_ulist_adapt_disable(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_enable(&list, 2u, 2u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_adapt_disable(&list));
+    _fill(3000u);
+
+    TEST_ASSERT_EQUAL(NODE_SIZE, list.items_per_node);
+}
+
+int main(int argc, char *argv[])
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_adapt_invalid_params);
+    RUN_TEST(test_ulist_adapt_grows_for_lookups);
+    RUN_TEST(test_ulist_adapt_shrinks_for_shifts);
+    RUN_TEST(test_ulist_adapt_keeps_order);
+    RUN_TEST(test_ulist_adapt_disable);
+    return UNITY_END();
+}
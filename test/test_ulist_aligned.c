@@ -0,0 +1,264 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+
+#include "ulist_api.h"
+#include "ulist_adapt_api.h"
+#include "ulist_snapshot_api.h"
+
+#define ALIGNMENT (ULIST_CACHE_LINE_BYTES)
+#define PAGE_BYTES (4096u)
+#define NUM_ITEMS (2000u)
+
+static ulist_t list;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create_aligned(&list, sizeof(unsigned),
+                                                     ALIGNMENT, PAGE_BYTES));
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _verify(unsigned *expected, unsigned long long num_items)
+{
+    TEST_ASSERT_EQUAL(num_items, list.num_items);
+
+    for (unsigned long long i = 0u; i < num_items; i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &item));
+        TEST_ASSERT_EQUAL(expected[i], item);
+    }
+
+    // Every node must be page aligned, with cache line aligned items
+    for (ulist_node_t *node = list.head; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_EQUAL(0u, (uintptr_t) node % PAGE_BYTES);
+        TEST_ASSERT_EQUAL(0u, (uintptr_t) node->items % ALIGNMENT);
+        TEST_ASSERT_TRUE(node->used <= node->capacity);
+    }
+}
+
+void test_ulist_aligned_invalid_params(void)
+{
+    ulist_t other;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(NULL, 4u, ALIGNMENT, PAGE_BYTES));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 0u, ALIGNMENT, PAGE_BYTES));
+
+    // Alignment must be a power of 2, and at least pointer sized
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 4u, 0u, PAGE_BYTES));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 4u, 2u, PAGE_BYTES));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 4u, 48u, PAGE_BYTES));
+
+    // Node size must be a multiple of the alignment, with room for 2 items
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 4u, ALIGNMENT, 100u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 4u, ALIGNMENT, ALIGNMENT));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_aligned(&other, 64u, ALIGNMENT, 128u));
+
+    // Adaptive node capacity would change the node size
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_adapt_enable(&list, 2u, 64u));
+}
+
+void test_ulist_aligned_items_per_node(void)
+{
+    size_t size_bytes;
+    size_t header_bytes = ((sizeof(ulist_node_t) + ALIGNMENT - 1u) / ALIGNMENT)
+                          * ALIGNMENT;
+
+    TEST_ASSERT_EQUAL((PAGE_BYTES - header_bytes) / sizeof(unsigned),
+                      list.items_per_node);
+    TEST_ASSERT_EQUAL(list.items_per_node, list.edge_items_per_node);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_node_size_bytes(&list, &size_bytes));
+    TEST_ASSERT_EQUAL(PAGE_BYTES, size_bytes);
+
+    // Node sizes that are not a power of 2 are only aligned to alignment
+    ulist_t other;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create_aligned(&other, 24u, 32u, 480u));
+    TEST_ASSERT_EQUAL(32u, other.node_alignment);
+    TEST_ASSERT_EQUAL((480u - header_bytes) / 24u, other.items_per_node);
+
+    for (unsigned i = 0u; i < 100u; i++)
+    {
+        char item[24] = {0};
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&other, item));
+    }
+
+    for (ulist_node_t *node = other.head; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_EQUAL(0u, (uintptr_t) node->items % 32u);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_node_size_bytes(&other, &size_bytes));
+    TEST_ASSERT_EQUAL(480u, size_bytes);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&other));
+}
+
+void test_ulist_aligned_random_edits(void)
+{
+    unsigned *expected = malloc(NUM_ITEMS * sizeof(unsigned));
+    unsigned long long num_items = 0u;
+
+    TEST_ASSERT_NOT_NULL(expected);
+    srand(50u);
+
+    for (unsigned i = 0u; i < (NUM_ITEMS * 2u); i++)
+    {
+        if ((num_items < NUM_ITEMS) && ((0u == num_items) || (rand() % 3)))
+        {
+            unsigned long long index = (unsigned) rand() % (num_items + 1u);
+            memmove(&expected[index + 1u], &expected[index],
+                    (num_items - index) * sizeof(unsigned));
+            expected[index] = i;
+            num_items += 1u;
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, index, &i));
+        }
+        else
+        {
+            unsigned long long index = (unsigned) rand() % num_items;
+            unsigned item;
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, index, &item));
+            TEST_ASSERT_EQUAL(expected[index], item);
+            num_items -= 1u;
+            memmove(&expected[index], &expected[index + 1u],
+                    (num_items - index) * sizeof(unsigned));
+        }
+    }
+
+    _verify(expected, num_items);
+    free(expected);
+}
+
+void test_ulist_aligned_snapshot_and_clone(void)
+{
+    ulist_snapshot_t snapshot;
+    ulist_t clone;
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &snapshot));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&list, &clone));
+
+    // Writing to shared nodes copies them, and the copies must be aligned too
+    for (unsigned i = 0u; i < NUM_ITEMS; i += 100u)
+    {
+        unsigned item = i + 1u;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, i, NULL));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, i, &item));
+    }
+
+    for (ulist_node_t *node = list.head; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_EQUAL(0u, (uintptr_t) node->items % ALIGNMENT);
+    }
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_get_item(&snapshot, i,
+                                                            &item));
+        TEST_ASSERT_EQUAL(i, item);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&clone, i, &item));
+        TEST_ASSERT_EQUAL(i, item);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &item));
+        TEST_ASSERT_EQUAL((0u == (i % 100u)) ? i + 1u : i, item);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&clone));
+}
+
+void test_ulist_aligned_memory_report(void)
+{
+    ulist_memory_report_t report;
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&list, &report));
+    TEST_ASSERT_EQUAL(list.nodes * PAGE_BYTES, report.total_bytes);
+    TEST_ASSERT_EQUAL(report.total_bytes, report.item_bytes
+                      + report.header_bytes + report.unused_bytes);
+}
+
+void test_ulist_aligned_clear_keeps_nodes(void)
+{
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    unsigned long long nodes = list.nodes;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, nodes));
+
+    // Reused nodes keep their aligned items
+    unsigned *expected = malloc(NUM_ITEMS * sizeof(unsigned));
+    TEST_ASSERT_NOT_NULL(expected);
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        expected[i] = NUM_ITEMS - i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &expected[i]));
+    }
+
+    _verify(expected, NUM_ITEMS);
+    free(expected);
+}
+
+void test_ulist_aligned_huge_page_nodes(void)
+{
+    ulist_t other;
+    size_t node_bytes = 2u * 1024u * 1024u;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create_aligned(&other, sizeof(unsigned),
+                                                     ALIGNMENT, node_bytes));
+
+    for (unsigned i = 0u; i < (other.items_per_node + 1u); i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&other, &i));
+    }
+
+    TEST_ASSERT_EQUAL(2u, other.nodes);
+
+    for (ulist_node_t *node = other.head; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_EQUAL(0u, (uintptr_t) node % node_bytes);
+    }
+
+    unsigned item;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&other, other.items_per_node,
+                                               &item));
+    TEST_ASSERT_EQUAL(other.items_per_node, item);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&other));
+}
+
+int main(int argc, char *argv[])
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_aligned_invalid_params);
+    RUN_TEST(test_ulist_aligned_items_per_node);
+    RUN_TEST(test_ulist_aligned_random_edits);
+    RUN_TEST(test_ulist_aligned_snapshot_and_clone);
+    RUN_TEST(test_ulist_aligned_memory_report);
+    RUN_TEST(test_ulist_aligned_clear_keeps_nodes);
+    RUN_TEST(test_ulist_aligned_huge_page_nodes);
+    return UNITY_END();
+}
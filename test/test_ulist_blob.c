@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+
+#include "ulist_blob_api.h"
+
+#define NODE_BYTES (256u)
+#define NUM_BLOBS (2000u)
+#define MAX_BLOB_BYTES (100u)
+
+static ulist_blob_t list;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_create(&list, NODE_BYTES));
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_destroy(&list));
+}
+
+// Blob contents are derived from a key, so they can be checked later
+static size_t _make_blob(unsigned key, char *blob)
+{
+    size_t size_bytes = key % MAX_BLOB_BYTES;
+
+    for (size_t i = 0u; i < size_bytes; i++)
+    {
+        blob[i] = (char) (key + i);
+    }
+
+    return size_bytes;
+}
+
+static void _check_blob(unsigned long long index, unsigned key)
+{
+    char expected[MAX_BLOB_BYTES];
+    size_t expected_bytes = _make_blob(key, expected);
+    void *blob;
+    size_t size_bytes;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_get(&list, index, &blob,
+                                               &size_bytes));
+    TEST_ASSERT_EQUAL(expected_bytes, size_bytes);
+    TEST_ASSERT_EQUAL(0, memcmp(expected, blob, size_bytes));
+}
+
+static void _check_nodes(void)
+{
+    unsigned long long nodes = 0u;
+    unsigned long long blobs = 0u;
+
+    for (ulist_blob_node_t *node = list.head; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_TRUE((node->used_bytes + (node->used * 4u))
+                         <= node->capacity_bytes);
+        TEST_ASSERT_TRUE((list.head == node) || (node->previous->next == node));
+        TEST_ASSERT_TRUE((1u == list.nodes) || (node->used > 0u));
+        nodes += 1u;
+        blobs += node->used;
+    }
+
+    TEST_ASSERT_EQUAL(list.nodes, nodes);
+    TEST_ASSERT_EQUAL(list.num_items, blobs);
+}
+
+void test_ulist_blob_invalid_params(void)
+{
+    ulist_blob_t other;
+    void *blob;
+    size_t size_bytes;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_blob_create(NULL, NODE_BYTES));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_blob_create(&other, 16u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_blob_append(NULL, "a", 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_blob_append(&list, NULL, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_blob_insert(&list, 1u, "a", 1u));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_blob_get(&list, 0u, &blob, &size_bytes));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_blob_pop(&list, 0u, NULL, NULL));
+}
+
+void test_ulist_blob_append_get(void)
+{
+    char blob[MAX_BLOB_BYTES];
+
+    for (unsigned i = 0u; i < NUM_BLOBS; i++)
+    {
+        size_t size_bytes = _make_blob(i, blob);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, blob, size_bytes));
+    }
+
+    TEST_ASSERT_EQUAL(NUM_BLOBS, list.num_items);
+    _check_nodes();
+
+    // Appending leaves full nodes behind
+    for (ulist_blob_node_t *node = list.head; list.tail != node;
+         node = node->next)
+    {
+        TEST_ASSERT_TRUE((node->used_bytes + (node->used * 4u))
+                         > (NODE_BYTES - MAX_BLOB_BYTES - 4u));
+    }
+
+    for (unsigned i = 0u; i < NUM_BLOBS; i++)
+    {
+        _check_blob(i, i);
+    }
+}
+
+void test_ulist_blob_strings(void)
+{
+    char string[32];
+
+    for (unsigned i = 0u; i < 100u; i++)
+    {
+        snprintf(string, sizeof(string), "item %u", i);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_insert(&list, 0u, string,
+                                                      strlen(string) + 1u));
+    }
+
+    for (unsigned i = 0u; i < 100u; i++)
+    {
+        void *blob;
+        size_t size_bytes;
+
+        snprintf(string, sizeof(string), "item %u", 99u - i);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_get(&list, i, &blob,
+                                                   &size_bytes));
+        TEST_ASSERT_EQUAL_STRING(string, (char *) blob);
+    }
+}
+
+void test_ulist_blob_large_blob(void)
+{
+    static char large[NODE_BYTES * 4u];
+    char buf[NODE_BYTES * 4u];
+    size_t size_bytes = sizeof(buf);
+
+    memset(large, 'x', sizeof(large));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, "a", 1u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, "c", 1u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_insert(&list, 1u, large,
+                                                  sizeof(large)));
+    TEST_ASSERT_EQUAL(3u, list.num_items);
+    _check_nodes();
+
+    // Buffer too small, nothing is removed
+    size_bytes = 10u;
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_blob_pop(&list, 1u, buf, &size_bytes));
+    TEST_ASSERT_EQUAL(sizeof(large), size_bytes);
+    TEST_ASSERT_EQUAL(3u, list.num_items);
+
+    size_bytes = sizeof(buf);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_pop(&list, 1u, buf, &size_bytes));
+    TEST_ASSERT_EQUAL(sizeof(large), size_bytes);
+    TEST_ASSERT_EQUAL(0, memcmp(large, buf, sizeof(large)));
+    _check_nodes();
+
+    size_bytes = sizeof(buf);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_pop(&list, 1u, buf, &size_bytes));
+    TEST_ASSERT_EQUAL(1u, size_bytes);
+    TEST_ASSERT_EQUAL('c', buf[0]);
+}
+
+void test_ulist_blob_large_blob_in_empty_list(void)
+{
+    static char large[NODE_BYTES * 2u];
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, large,
+                                                  sizeof(large)));
+    TEST_ASSERT_EQUAL(1u, list.nodes);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_pop(&list, 0u, NULL, NULL));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, "a", 1u));
+    _check_nodes();
+}
+
+void test_ulist_blob_split_oversized_node(void)
+{
+    static char large[NODE_BYTES * 4u];
+    static unsigned keys[NODE_BYTES];
+    unsigned long long num_keys = 0u;
+    char blob[MAX_BLOB_BYTES];
+
+    // The only node keeps its large capacity after its blob is popped
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, large,
+                                                  sizeof(large)));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_pop(&list, 0u, NULL, NULL));
+
+    // Fill it with small blobs
+    while (list.nodes < 2u)
+    {
+        keys[num_keys] = 8u + (MAX_BLOB_BYTES * (unsigned) num_keys);
+        size_t size_bytes = _make_blob(keys[num_keys], blob);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, blob,
+                                                      size_bytes));
+        num_keys += 1u;
+    }
+
+    // Splitting it must not squeeze half of it into a regular node
+    unsigned key = 12u;
+    size_t size_bytes = _make_blob(key, blob);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_insert(&list, 20u, blob,
+                                                  size_bytes));
+    for (unsigned long long i = num_keys; i > 20u; i--)
+    {
+        keys[i] = keys[i - 1u];
+    }
+
+    keys[20] = key;
+    num_keys += 1u;
+
+    _check_nodes();
+
+    for (unsigned long long i = 0u; i < num_keys; i++)
+    {
+        _check_blob(i, keys[i]);
+    }
+}
+
+void test_ulist_blob_random_edits(void)
+{
+    static unsigned keys[NUM_BLOBS];
+    unsigned long long num_blobs = 0u;
+    char blob[MAX_BLOB_BYTES];
+
+    for (unsigned i = 0u; i < (8u * NUM_BLOBS); i++)
+    {
+        unsigned long long index = (unsigned) rand() % (num_blobs + 1u);
+
+        if ((num_blobs < NUM_BLOBS) && ((0u == num_blobs) || (rand() & 1)))
+        {
+            unsigned key = (unsigned) rand();
+            size_t size_bytes = _make_blob(key, blob);
+
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_insert(&list, index, blob,
+                                                          size_bytes));
+            memmove(&keys[index + 1u], &keys[index],
+                    (num_blobs - index) * sizeof(unsigned));
+            keys[index] = key;
+            num_blobs += 1u;
+        }
+        else
+        {
+            char expected[MAX_BLOB_BYTES];
+            size_t size_bytes = sizeof(blob);
+
+            index %= num_blobs;
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_pop(&list, index, blob,
+                                                       &size_bytes));
+            TEST_ASSERT_EQUAL(_make_blob(keys[index], expected), size_bytes);
+            TEST_ASSERT_EQUAL(0, memcmp(expected, blob, size_bytes));
+            memmove(&keys[index], &keys[index + 1u],
+                    (num_blobs - index - 1u) * sizeof(unsigned));
+            num_blobs -= 1u;
+        }
+    }
+
+    TEST_ASSERT_EQUAL(num_blobs, list.num_items);
+    _check_nodes();
+
+    for (unsigned long long i = 0u; i < num_blobs; i++)
+    {
+        _check_blob(i, keys[i]);
+    }
+}
+
+void test_ulist_blob_pop_merges_nodes(void)
+{
+    char blob[MAX_BLOB_BYTES];
+
+    for (unsigned i = 0u; i < NUM_BLOBS; i++)
+    {
+        size_t size_bytes = _make_blob(i, blob);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_append(&list, blob, size_bytes));
+    }
+
+    unsigned long long full_nodes = list.nodes;
+
+    // Pop every other blob; nodes are merged as they drop below half full
+    for (unsigned i = 0u; i < (NUM_BLOBS / 2u); i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_blob_pop(&list, i, NULL, NULL));
+    }
+
+    _check_nodes();
+    TEST_ASSERT_TRUE(list.nodes < full_nodes);
+
+    for (unsigned i = 0u; i < (NUM_BLOBS / 2u); i++)
+    {
+        _check_blob(i, (2u * i) + 1u);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_blob_invalid_params);
+    RUN_TEST(test_ulist_blob_append_get);
+    RUN_TEST(test_ulist_blob_strings);
+    RUN_TEST(test_ulist_blob_large_blob);
+    RUN_TEST(test_ulist_blob_large_blob_in_empty_list);
+    RUN_TEST(test_ulist_blob_split_oversized_node);
+    RUN_TEST(test_ulist_blob_random_edits);
+    RUN_TEST(test_ulist_blob_pop_merges_nodes);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#include "unity.h"
+
+#include "ulist_api.h"
+
+#define NODE_SIZE (8u)
+
+static ulist_t list;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _append(ulist_t *l, int num_items)
+{
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(l, &i));
+    }
+}
+
+static void _verify(ulist_t *l, int num_items)
+{
+    TEST_ASSERT_EQUAL(num_items, l->num_items);
+
+    for (int i = 0; i < num_items; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(l, i, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+}
+
+void test_ulist_clear_invalid_params(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_clear(NULL, 0u));
+}
+
+void test_ulist_clear_frees_nodes(void)
+{
+    void *item;
+
+    _append(&list, NODE_SIZE * 10);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 0u));
+
+    TEST_ASSERT_EQUAL(0u, list.num_items);
+    TEST_ASSERT_EQUAL(1u, list.nodes);
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    TEST_ASSERT_EQUAL_PTR(list.head, list.tail);
+    TEST_ASSERT_EQUAL(0u, list.head->used);
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_get_next_item(&list, &item));
+
+    _append(&list, NODE_SIZE * 3);
+    _verify(&list, NODE_SIZE * 3);
+}
+
+void test_ulist_clear_keeps_nodes(void)
+{
+    _append(&list, NODE_SIZE * 10);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 4u));
+
+    TEST_ASSERT_EQUAL(1u, list.nodes);
+    TEST_ASSERT_EQUAL(4u, list.spare_nodes);
+
+    // Refilling takes the kept nodes first
+    _append(&list, NODE_SIZE * 5);
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    _verify(&list, NODE_SIZE * 5);
+
+    // Existing spare nodes count towards the number kept
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, NODE_SIZE * 3));
+    TEST_ASSERT_EQUAL(3u, list.spare_nodes);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 5u));
+    TEST_ASSERT_EQUAL(5u, list.spare_nodes);
+}
+
+void test_ulist_clear_leaves_clone_untouched(void)
+{
+    ulist_t clone;
+
+    _append(&list, NODE_SIZE * 4);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&list, &clone));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 10u));
+    TEST_ASSERT_EQUAL(0u, list.num_items);
+
+    // Nodes shared with the clone can't be kept
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    _verify(&clone, NODE_SIZE * 4);
+
+    _append(&list, NODE_SIZE);
+    _verify(&list, NODE_SIZE);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&clone));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_clear_invalid_params);
+    RUN_TEST(test_ulist_clear_frees_nodes);
+    RUN_TEST(test_ulist_clear_keeps_nodes);
+    RUN_TEST(test_ulist_clear_leaves_clone_untouched);
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+#include "unity.h"
+
+#include "ulist_api.h"
+#include "ulist_snapshot_api.h"
+#include "ulist_parallel_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_ITEMS (400)
+
+static ulist_t list;
+static ulist_t clone;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+
+   for (int i = 0; i < NUM_ITEMS; i++)
+   {
+       TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+   }
+
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&list, &clone));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&clone));
+}
+
+// Check that a list holds the items 0 to num_items - 1, in order
+static void _verify_items(ulist_t *l, int num_items)
+{
+    TEST_ASSERT_EQUAL(num_items, l->num_items);
+
+    for (int i = 0; i < num_items; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(l, i, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+}
+
+static unsigned long long _count_shared(ulist_t *l)
+{
+    unsigned long long shared = 0u;
+
+    for (ulist_node_t *node = l->head; NULL != node; node = node->next)
+    {
+        shared += (NULL != node->owner) ? 1u : 0u;
+    }
+
+    return shared;
+}
+
+void test_clone_null(void)
+{
+    ulist_t other;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_clone(NULL, &other));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_clone(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_clone(&list, &list));
+}
+
+void test_clone_shares_nodes(void)
+{
+    _verify_items(&clone, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(list.nodes, clone.nodes);
+    TEST_ASSERT_EQUAL(clone.nodes, _count_shared(&clone));
+
+    ulist_node_t *node = list.head;
+    ulist_node_t *proxy = clone.head;
+
+    while (NULL != node)
+    {
+        TEST_ASSERT_EQUAL_PTR(node, proxy->owner);
+        TEST_ASSERT_EQUAL_PTR(node->items, proxy->items);
+        node = node->next;
+        proxy = proxy->next;
+    }
+}
+
+void test_clone_write_copies_one_node(void)
+{
+    int val = -1;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&clone, 0u, &val));
+    TEST_ASSERT_EQUAL(0, val);
+    TEST_ASSERT_EQUAL(clone.nodes - 1u, _count_shared(&clone));
+
+    // Original is untouched
+    _verify_items(&list, NUM_ITEMS);
+}
+
+void test_clone_writes_diverge(void)
+{
+    // Modify both lists in different places
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int val = -i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, i * 2, &val));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&clone, clone.num_items - 1u,
+                                                   NULL));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&clone, &val));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&clone, clone.num_items - 1u,
+                                                   NULL));
+    }
+
+    TEST_ASSERT_EQUAL(0u, clone.num_items);
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, (i * 2) + 1, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+}
+
+void test_clone_of_clone(void)
+{
+    ulist_t second;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&clone, &second));
+
+    // Proxies always refer to the node that owns the data
+    TEST_ASSERT_EQUAL_PTR(list.head, second.head->owner);
+
+    // Destroy the original first; clones keep the shared data alive
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+    _verify_items(&second, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&second));
+    _verify_items(&clone, NUM_ITEMS);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+}
+
+void test_clone_snapshot(void)
+{
+    ulist_snapshot_t snapshot;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&clone, &snapshot));
+
+    while (clone.num_items > 0u)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&clone, 0u, NULL));
+    }
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_get_item(&snapshot, i,
+                                                            &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+    _verify_items(&list, NUM_ITEMS);
+}
+
+static void _add_num_items(const ulist_span_t *span, void *ctx)
+{
+    for (size_t i = 0u; i < span->count; i++)
+    {
+        ((int *) span->items)[i] += NUM_ITEMS;
+    }
+}
+
+void test_clone_write_through_pointers(void)
+{
+    ulist_snapshot_t snapshot;
+    void *item;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&clone, &snapshot));
+
+    // Every API that hands out writable item pointers must copy shared nodes
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item_pointer(&clone, 5u, &item));
+    *(int *) item = -5;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_set_iteration_start_index(&clone, 100u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_next_item(&clone, &item));
+    *(int *) item = -100;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_set_iteration_start_index(&clone, 200u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_previous_item(&clone, &item));
+    *(int *) item = -200;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_parallel_for_each(&clone, _add_num_items,
+                                                        NULL, 4u));
+    TEST_ASSERT_EQUAL(0u, _count_shared(&clone));
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int val;
+        int expected = ((5 == i) || (100 == i) || (200 == i)) ? -i : i;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&clone, i, &val));
+        TEST_ASSERT_EQUAL(expected + NUM_ITEMS, val);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_get_item(&snapshot, i,
+                                                            &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+    _verify_items(&list, NUM_ITEMS);
+}
+
+void test_clone_empty(void)
+{
+    ulist_t empty;
+    ulist_t other;
+    int val = 5;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&empty, sizeof(int), NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&empty, &other));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&other, &val));
+    TEST_ASSERT_EQUAL(0u, empty.num_items);
+    TEST_ASSERT_EQUAL(1u, other.num_items);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&empty));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&other));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_clone_null);
+    RUN_TEST(test_clone_shares_nodes);
+    RUN_TEST(test_clone_write_copies_one_node);
+    RUN_TEST(test_clone_writes_diverge);
+    RUN_TEST(test_clone_of_clone);
+    RUN_TEST(test_clone_snapshot);
+    RUN_TEST(test_clone_write_through_pointers);
+    RUN_TEST(test_clone_empty);
+    return UNITY_END();
+}
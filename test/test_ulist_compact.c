@@ -0,0 +1,206 @@
+#include <stdlib.h>
+
+#include "unity.h"
+
+#include "ulist_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_NODES (100u)
+
+static ulist_t list;
+static int expected[NODE_SIZE * NUM_NODES * 2u];
+static unsigned long long num_expected;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+   num_expected = 0u;
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _pop(unsigned long long index)
+{
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, index, &val));
+    TEST_ASSERT_EQUAL(expected[index], val);
+
+    for (unsigned long long i = index; (i + 1u) < num_expected; i++)
+    {
+        expected[i] = expected[i + 1u];
+    }
+
+    num_expected -= 1u;
+}
+
+// Fill NUM_NODES nodes, then pop items until every node is about half full
+static void _fill_and_thin_out(void)
+{
+    for (int i = 0; i < (int) (NODE_SIZE * NUM_NODES); i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+        expected[num_expected++] = i;
+    }
+
+    for (unsigned long long i = 0u; i < NUM_NODES; i++)
+    {
+        for (unsigned j = 0u; j < ((NODE_SIZE / 2u) - 1u); j++)
+        {
+            _pop((i * ((NODE_SIZE / 2u) + 1u)) + 1u);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(NUM_NODES, list.nodes);
+}
+
+static void _verify(void)
+{
+    TEST_ASSERT_EQUAL(num_expected, list.num_items);
+
+    for (unsigned long long i = 0u; i < num_expected; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(expected[i], val);
+    }
+}
+
+// Check that every node except the tail holds exactly fill items
+static void _verify_packed(size_t fill)
+{
+    unsigned long long nodes = 0u;
+
+    for (ulist_node_t *node = list.head; NULL != node; node = node->next)
+    {
+        if (node != list.tail)
+        {
+            TEST_ASSERT_EQUAL(fill, node->used);
+        }
+
+        nodes += 1u;
+    }
+
+    TEST_ASSERT_EQUAL((num_expected + fill - 1u) / fill, nodes);
+    TEST_ASSERT_EQUAL(nodes, list.nodes);
+}
+
+void test_ulist_compact_invalid_params(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_compact(NULL, 0u, 0u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_compact(&list, NODE_SIZE + 1u, 0u));
+}
+
+void test_ulist_compact_empty_list(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_compact(&list, 0u, 0u));
+    TEST_ASSERT_EQUAL(1u, list.nodes);
+}
+
+void test_ulist_compact_full(void)
+{
+    _fill_and_thin_out();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_compact(&list, 0u, 0u));
+    _verify_packed(NODE_SIZE);
+    _verify();
+}
+
+void test_ulist_compact_target_fill(void)
+{
+    _fill_and_thin_out();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_compact(&list, NODE_SIZE - 2u, 0u));
+    _verify_packed(NODE_SIZE - 2u);
+    _verify();
+
+    // Nodes that are already fuller than the target are left alone
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_compact(&list, NODE_SIZE / 2u, 0u));
+    _verify_packed(NODE_SIZE - 2u);
+}
+
+void test_ulist_compact_incremental(void)
+{
+    unsigned calls = 1u;
+
+    _fill_and_thin_out();
+
+    while (ULIST_IN_PROGRESS == ulist_compact(&list, 0u, 16u))
+    {
+        calls += 1u;
+    }
+
+    TEST_ASSERT_TRUE(calls > 10u);
+    _verify_packed(NODE_SIZE);
+    _verify();
+}
+
+void test_ulist_compact_incremental_with_modifications(void)
+{
+    ulist_status_e err;
+    int val = -1;
+
+    srand(99);
+    _fill_and_thin_out();
+
+    do
+    {
+        err = ulist_compact(&list, 0u, 8u);
+        TEST_ASSERT_TRUE((ULIST_OK == err) || (ULIST_IN_PROGRESS == err));
+
+        _pop((unsigned long long) rand() % num_expected);
+
+        unsigned long long index = (unsigned long long) rand() % num_expected;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, index, &val));
+
+        for (unsigned long long i = num_expected; i > index; i--)
+        {
+            expected[i] = expected[i - 1u];
+        }
+
+        expected[index] = val--;
+        num_expected += 1u;
+    }
+    while (ULIST_IN_PROGRESS == err);
+
+    _verify();
+    TEST_ASSERT_TRUE(list.nodes < NUM_NODES);
+}
+
+void test_ulist_compact_leaves_clone_untouched(void)
+{
+    ulist_t clone;
+
+    _fill_and_thin_out();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&list, &clone));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_compact(&list, 0u, 0u));
+    _verify_packed(NODE_SIZE);
+
+    TEST_ASSERT_EQUAL(NUM_NODES, clone.nodes);
+
+    for (unsigned long long i = 0u; i < num_expected; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&clone, i, &val));
+        TEST_ASSERT_EQUAL(expected[i], val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&clone));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_compact_invalid_params);
+    RUN_TEST(test_ulist_compact_empty_list);
+    RUN_TEST(test_ulist_compact_full);
+    RUN_TEST(test_ulist_compact_target_fill);
+    RUN_TEST(test_ulist_compact_incremental);
+    RUN_TEST(test_ulist_compact_incremental_with_modifications);
+    RUN_TEST(test_ulist_compact_leaves_clone_untouched);
+    return UNITY_END();
+}
@@ -0,0 +1,257 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "ulist_fine_api.h"
+
+#define NODE_SIZE (4u)
+#define HALF_FULL (2u)
+#define NUM_THREADS (4)
+#define ITEMS_PER_THREAD (1000)
+#define TOTAL_ITEMS (NUM_THREADS * ITEMS_PER_THREAD)
+
+static ulist_fine_t list;
+static unsigned char _seen[TOTAL_ITEMS];
+
+typedef struct {
+    int id;
+    unsigned int seed;
+    int popped[ITEMS_PER_THREAD];
+    int num_popped;
+} thread_args_t;
+
+static thread_args_t _args[NUM_THREADS];
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_create(&list, sizeof(int), NODE_SIZE));
+   memset(_seen, 0, sizeof(_seen));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_destroy(&list));
+}
+
+void _verify_node_item_ratio(ulist_t *list)
+{
+    ulist_node_t *node = list->head;
+    size_t item_count = 0;
+    size_t node_count = 0;
+
+    while (NULL != node)
+    {
+        if (node != list->tail)
+        {
+            TEST_ASSERT_TRUE(node->used >= HALF_FULL);
+        }
+
+        TEST_ASSERT_EQUAL(0u, node->lock);
+        item_count += node->used;
+        node_count += 1u;
+        node = node->next;
+    }
+
+    TEST_ASSERT_EQUAL(list->num_items, item_count);
+    TEST_ASSERT_EQUAL(list->nodes, node_count);
+}
+
+// Inserts or appends all of this thread's items at random positions
+static void *_insert_thread(void *arg)
+{
+    thread_args_t *args = (thread_args_t *) arg;
+
+    for (int i = 0; i < ITEMS_PER_THREAD; i++)
+    {
+        int val = (args->id * ITEMS_PER_THREAD) + i;
+        unsigned long long num_items;
+        ulist_status_e err;
+
+        ulist_fine_num_items(&list, &num_items);
+
+        if (0 == (i % 3))
+        {
+            err = ulist_fine_append_item(&list, &val);
+        }
+        else
+        {
+            unsigned long long index = rand_r(&args->seed) % (num_items + 1u);
+            err = ulist_fine_insert_item(&list, index, &val);
+        }
+
+        if (ULIST_OK != err)
+        {
+            return (void *) 1;
+        }
+    }
+
+    return NULL;
+}
+
+// Pops half as many items as were inserted per thread, from random positions
+static void *_pop_thread(void *arg)
+{
+    thread_args_t *args = (thread_args_t *) arg;
+
+    args->num_popped = 0;
+
+    while (args->num_popped < (ITEMS_PER_THREAD / 2))
+    {
+        unsigned long long num_items;
+        ulist_fine_num_items(&list, &num_items);
+
+        unsigned long long index = rand_r(&args->seed) % num_items;
+        int val;
+
+        ulist_status_e err = ulist_fine_pop_item(&list, index, &val);
+        if (ULIST_OK == err)
+        {
+            args->popped[args->num_popped++] = val;
+        }
+        else if (ULIST_INDEX_OUT_OF_RANGE != err)
+        {
+            return (void *) 1;
+        }
+    }
+
+    return NULL;
+}
+
+static void _run_threads(void *(*fn)(void *))
+{
+    pthread_t threads[NUM_THREADS];
+    void *ret;
+
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, fn, &_args[i]));
+    }
+
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_join(threads[i], &ret));
+        TEST_ASSERT_NULL(ret);
+    }
+}
+
+void test_fine_null(void)
+{
+    int val = 0;
+    unsigned long long num_items;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_create(NULL, sizeof(int), NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_append_item(NULL, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_append_item(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_insert_item(&list, 0u, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_get_item(&list, 0u, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_pop_item(NULL, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_fine_num_items(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_num_items(&list, &num_items));
+    TEST_ASSERT_EQUAL(0u, num_items);
+}
+
+void test_fine_out_of_range(void)
+{
+    int val = 6;
+
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_fine_get_item(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_fine_pop_item(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_fine_insert_item(&list, 1u, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_insert_item(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_fine_get_item(&list, 1u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_fine_insert_item(&list, 2u, &val));
+}
+
+void test_fine_single_thread(void)
+{
+    int num_items = 500;
+
+    // Build the list from the middle outwards, so nodes get split everywhere
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_insert_item(&list, i / 2, &i));
+        _verify_node_item_ratio(&list.list);
+    }
+
+    int expected[num_items];
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list.list, i, &expected[i]));
+    }
+
+    for (int i = 0; i < num_items; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(expected[i], val);
+    }
+
+    // Pop from the tail, the middle and the head in turn
+    for (int i = 0; i < num_items; i++)
+    {
+        unsigned long long size = list.list.num_items;
+        unsigned long long index = (i % 3 == 0) ? size - 1u
+                                 : (i % 3 == 1) ? size / 2u : 0u;
+        int check;
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list.list, index, &check));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_pop_item(&list, index, &val));
+        TEST_ASSERT_EQUAL(check, val);
+        _verify_node_item_ratio(&list.list);
+    }
+
+    TEST_ASSERT_EQUAL(0u, list.list.num_items);
+}
+
+void test_fine_concurrent(void)
+{
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        _args[i].id = i;
+        _args[i].seed = i + 1u;
+    }
+
+    _run_threads(_insert_thread);
+    TEST_ASSERT_EQUAL(TOTAL_ITEMS, list.list.num_items);
+    _verify_node_item_ratio(&list.list);
+
+    _run_threads(_pop_thread);
+    TEST_ASSERT_EQUAL(TOTAL_ITEMS / 2, list.list.num_items);
+    _verify_node_item_ratio(&list.list);
+
+    // Every item should have been either popped or left in the list, once
+    for (int i = 0; i < NUM_THREADS; i++)
+    {
+        for (int j = 0; j < _args[i].num_popped; j++)
+        {
+            TEST_ASSERT_EQUAL(0, _seen[_args[i].popped[j]]);
+            _seen[_args[i].popped[j]] = 1;
+        }
+    }
+
+    for (unsigned long long i = 0; i < list.list.num_items; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_fine_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(0, _seen[val]);
+        _seen[val] = 1;
+    }
+
+    for (int i = 0; i < TOTAL_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(1, _seen[i]);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fine_null);
+    RUN_TEST(test_fine_out_of_range);
+    RUN_TEST(test_fine_single_thread);
+    RUN_TEST(test_fine_concurrent);
+    return UNITY_END();
+}
@@ -78,6 +78,26 @@ void test_get_everything(void)
     TEST_ASSERT_EQUAL(list.num_items, num_items);
 }
 
+void test_get_pointer_everything(void)
+{
+    int num_items = 1000;
+    void *read_ptr;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_get_item_pointer(&list, 0u, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_get_item_pointer(&list, 0u, &read_ptr));
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item_pointer(&list, i, &read_ptr));
+        TEST_ASSERT_EQUAL(*(int *)read_ptr, i);
+    }
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -86,5 +106,6 @@ int main(void)
     RUN_TEST(test_get_empty);
     RUN_TEST(test_get_index_out_of_range);
     RUN_TEST(test_get_everything);
+    RUN_TEST(test_get_pointer_everything);
     return UNITY_END();
 }
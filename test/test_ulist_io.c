@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "unity.h"
+
+#include "ulist_io_api.h"
+
+#define NODE_SIZE (8u)
+
+static ulist_t list;
+static ulist_t loaded;
+static FILE *file;
+static int fd;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+   TEST_ASSERT_NOT_NULL(file = tmpfile());
+   fd = fileno(file);
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+   fclose(file);
+}
+
+// Save list, load it back into loaded, and check the contents match
+static void _save_and_load(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_save(&list, fd));
+    TEST_ASSERT_EQUAL(0, lseek(fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_load(&loaded, fd));
+
+    TEST_ASSERT_EQUAL(list.item_size_bytes, loaded.item_size_bytes);
+    TEST_ASSERT_EQUAL(list.items_per_node, loaded.items_per_node);
+    TEST_ASSERT_EQUAL(list.num_items, loaded.num_items);
+
+    for (unsigned long long i = 0u; i < list.num_items; i++)
+    {
+        int expected;
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &expected));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&loaded, i, &val));
+        TEST_ASSERT_EQUAL(expected, val);
+    }
+}
+
+// Check that all nodes of a loaded list are full, except the tail
+static void _verify_packed(ulist_t *l)
+{
+    unsigned long long nodes = 0u;
+
+    for (ulist_node_t *node = l->head; NULL != node; node = node->next)
+    {
+        if (node != l->tail)
+        {
+            TEST_ASSERT_EQUAL(l->items_per_node, node->used);
+        }
+
+        nodes += 1u;
+    }
+
+    TEST_ASSERT_EQUAL(l->nodes, nodes);
+    TEST_ASSERT_EQUAL((l->num_items == 0u) ? 1u
+                      : (l->num_items + l->items_per_node - 1u)
+                        / l->items_per_node, nodes);
+}
+
+void test_io_null(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_save(NULL, fd));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_save(&list, -1));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_load(NULL, fd));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_load(&loaded, -1));
+}
+
+void test_io_empty(void)
+{
+    _save_and_load();
+    _verify_packed(&loaded);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&loaded));
+}
+
+void test_io_sizes(void)
+{
+    int sizes[] = {1, NODE_SIZE - 1, NODE_SIZE, NODE_SIZE + 1, 5000};
+
+    for (unsigned i = 0u; i < (sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int),
+                                                 NODE_SIZE));
+        TEST_ASSERT_EQUAL(0, ftruncate(fd, 0));
+        TEST_ASSERT_EQUAL(0, lseek(fd, 0, SEEK_SET));
+
+        for (int j = 0; j < sizes[i]; j++)
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, j / 2, &j));
+        }
+
+        _save_and_load();
+        _verify_packed(&loaded);
+        TEST_ASSERT_EQUAL(sizeof(ulist_io_header_t)
+                          + (sizes[i] * sizeof(int)), lseek(fd, 0, SEEK_CUR));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&loaded));
+    }
+}
+
+void test_io_loaded_list_usable(void)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    _save_and_load();
+
+    // Packed nodes are full, so inserts must split them
+    for (int i = 0; i < 100; i++)
+    {
+        int val = -i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&loaded, i * 2, &val));
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&loaded, (i * 2) + 1, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&loaded));
+}
+
+void test_io_bad_header(void)
+{
+    ulist_io_header_t header = {.magic = 0x12345678u};
+
+    TEST_ASSERT_EQUAL(sizeof(header), write(fd, &header, sizeof(header)));
+    TEST_ASSERT_EQUAL(0, lseek(fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT, ulist_load(&loaded, fd));
+
+    // Header cut short
+    TEST_ASSERT_EQUAL(0, ftruncate(fd, sizeof(header) / 2u));
+    TEST_ASSERT_EQUAL(0, lseek(fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT, ulist_load(&loaded, fd));
+}
+
+void test_io_truncated(void)
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_save(&list, fd));
+    TEST_ASSERT_EQUAL(0, ftruncate(fd, lseek(fd, 0, SEEK_CUR) - 1));
+    TEST_ASSERT_EQUAL(0, lseek(fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT, ulist_load(&loaded, fd));
+}
+
+void test_io_write_error(void)
+{
+    int fds[2];
+
+    TEST_ASSERT_EQUAL(0, pipe(fds));
+    close(fds[1]);
+    TEST_ASSERT_EQUAL(ULIST_ERROR_IO, ulist_save(&list, fds[0]));
+    close(fds[0]);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_io_null);
+    RUN_TEST(test_io_empty);
+    RUN_TEST(test_io_sizes);
+    RUN_TEST(test_io_loaded_list_usable);
+    RUN_TEST(test_io_bad_header);
+    RUN_TEST(test_io_truncated);
+    RUN_TEST(test_io_write_error);
+    return UNITY_END();
+}
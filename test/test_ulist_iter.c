@@ -0,0 +1,151 @@
+#include "unity.h"
+
+#include "ulist_api.h"
+
+#define NODE_SIZE (5u)
+
+static ulist_t list;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_iter_null(void)
+{
+    ulist_iter_t iter;
+    const void *val;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_iter_init(NULL, &iter, 0u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_iter_init(&list, NULL, 0u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, 0u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_iter_next(NULL, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_iter_next(&iter, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_iter_previous(NULL, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_iter_previous(&iter, NULL));
+}
+
+void test_iter_empty(void)
+{
+    ulist_iter_t iter;
+    const void *val;
+
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_iter_init(&list, &iter, 1u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, 0u));
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, 0u));
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_previous(&iter, &val));
+}
+
+void test_iter_out_of_range(void)
+{
+    ulist_iter_t iter;
+    int write_data = 7;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &write_data));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_iter_init(&list, &iter, 1u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, 0u));
+}
+
+void test_iter_next_everything(void)
+{
+    int num_items = 1000;
+    unsigned long long start_index = 643;
+    ulist_iter_t iter;
+    const void *val;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, 0u));
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_next(&iter, &val));
+        TEST_ASSERT_EQUAL(i, *(const int *)val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &val));
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &val));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, start_index));
+    for (int i = start_index; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_next(&iter, &val));
+        TEST_ASSERT_EQUAL(i, *(const int *)val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &val));
+}
+
+void test_iter_previous_everything(void)
+{
+    int num_items = 1000;
+    unsigned long long start_index = 643;
+    ulist_iter_t iter;
+    const void *val;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, num_items - 1));
+    for (int i = num_items - 1; i >= 0; i--)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_previous(&iter, &val));
+        TEST_ASSERT_EQUAL(i, *(const int *)val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_previous(&iter, &val));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, start_index));
+    for (int i = start_index; i >= 0; i--)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_previous(&iter, &val));
+        TEST_ASSERT_EQUAL(i, *(const int *)val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_previous(&iter, &val));
+}
+
+void test_iter_independent(void)
+{
+    int num_items = 100;
+    ulist_iter_t a, b;
+    const void *val_a, *val_b;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    // Two iterators over the same list should not affect each other
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &a, 0u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &b, num_items - 1));
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_next(&a, &val_a));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_previous(&b, &val_b));
+        TEST_ASSERT_EQUAL(i, *(const int *)val_a);
+        TEST_ASSERT_EQUAL(num_items - 1 - i, *(const int *)val_b);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_iter_null);
+    RUN_TEST(test_iter_empty);
+    RUN_TEST(test_iter_out_of_range);
+    RUN_TEST(test_iter_next_everything);
+    RUN_TEST(test_iter_previous_everything);
+    RUN_TEST(test_iter_independent);
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <unistd.h>
+
+#include "unity.h"
+
+#include "ulist_io_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_ITEMS (3000)
+
+static ulist_t list;
+static ulist_t mapped;
+static FILE *file;
+static int fd;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+   TEST_ASSERT_NOT_NULL(file = tmpfile());
+   fd = fileno(file);
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+   fclose(file);
+}
+
+static void _save_and_map(int num_items)
+{
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, i / 2, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_save(&list, fd));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_map(&mapped, fd));
+}
+
+void test_map_null(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_map(NULL, fd));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_map(&mapped, -1));
+}
+
+void test_map_get_item(void)
+{
+    _save_and_map(NUM_ITEMS);
+
+    TEST_ASSERT_EQUAL(NUM_ITEMS, mapped.num_items);
+    TEST_ASSERT_EQUAL((NUM_ITEMS + NODE_SIZE - 1u) / NODE_SIZE, mapped.nodes);
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int expected;
+        int val;
+        int *ptr;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &expected));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&mapped, i, &val));
+        TEST_ASSERT_EQUAL(expected, val);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item_pointer(&mapped, i,
+                                                           (void **) &ptr));
+        TEST_ASSERT_EQUAL(expected, *ptr);
+    }
+
+    int val;
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_get_item(&mapped, NUM_ITEMS, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&mapped));
+}
+
+void test_map_iteration(void)
+{
+    ulist_iter_t iter;
+    const void *item;
+
+    _save_and_map(NUM_ITEMS);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&mapped, &iter, 0u));
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int expected;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &expected));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_next(&iter, &item));
+        TEST_ASSERT_EQUAL(expected, *(const int *) item);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &item));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&mapped, &iter,
+                                                NUM_ITEMS - 1u));
+    for (int i = NUM_ITEMS - 1; i >= 0; i--)
+    {
+        int expected;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &expected));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_previous(&iter, &item));
+        TEST_ASSERT_EQUAL(expected, *(const int *) item);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_previous(&iter, &item));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&mapped));
+}
+
+void test_map_read_only(void)
+{
+    int val = 0;
+    void *ptr;
+
+    _save_and_map(10);
+
+    TEST_ASSERT_EQUAL(ULIST_READ_ONLY, ulist_append_item(&mapped, &val));
+    TEST_ASSERT_EQUAL(ULIST_READ_ONLY, ulist_insert_item(&mapped, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_READ_ONLY, ulist_pop_item(&mapped, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_get_next_item(&mapped, &ptr));
+    TEST_ASSERT_EQUAL(10u, mapped.num_items);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&mapped));
+}
+
+void test_map_empty(void)
+{
+    ulist_iter_t iter;
+    const void *item;
+
+    _save_and_map(0);
+
+    TEST_ASSERT_EQUAL(0u, mapped.num_items);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&mapped, &iter, 0u));
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &item));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&mapped));
+}
+
+void test_map_bad_file(void)
+{
+    // Empty file
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT, ulist_map(&mapped, fd));
+
+    // Items missing from the end
+    _save_and_map(0);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&mapped));
+
+    for (int i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(0, ftruncate(fd, 0));
+    TEST_ASSERT_EQUAL(0, lseek(fd, 0, SEEK_SET));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_save(&list, fd));
+    TEST_ASSERT_EQUAL(0, ftruncate(fd, lseek(fd, 0, SEEK_CUR) - 1));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT, ulist_map(&mapped, fd));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_map_null);
+    RUN_TEST(test_map_get_item);
+    RUN_TEST(test_map_iteration);
+    RUN_TEST(test_map_read_only);
+    RUN_TEST(test_map_empty);
+    RUN_TEST(test_map_bad_file);
+    return UNITY_END();
+}
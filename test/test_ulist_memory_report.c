@@ -0,0 +1,122 @@
+#include "unity.h"
+
+#include "ulist_api.h"
+
+#define NODE_SIZE (10u)
+
+static ulist_t list;
+static ulist_memory_report_t report;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _append(int num_items)
+{
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+}
+
+void test_ulist_memory_report_invalid_params(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_memory_report(NULL, &report));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_memory_report(&list, NULL));
+}
+
+void test_ulist_memory_report_empty_list(void)
+{
+    size_t node_size;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_node_size_bytes(&list, &node_size));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&list, &report));
+    TEST_ASSERT_EQUAL(1u, report.nodes);
+    TEST_ASSERT_EQUAL(node_size, report.total_bytes);
+    TEST_ASSERT_EQUAL(0u, report.item_bytes);
+    TEST_ASSERT_EQUAL(NODE_SIZE * sizeof(int), report.unused_bytes);
+    TEST_ASSERT_EQUAL(1u, report.underfull_nodes);
+    TEST_ASSERT_EQUAL(1u, report.fill_histogram[0]);
+}
+
+void test_ulist_memory_report_full_nodes(void)
+{
+    size_t node_size;
+
+    _append((NODE_SIZE * 3) + 3);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_node_size_bytes(&list, &node_size));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&list, &report));
+    TEST_ASSERT_EQUAL(4u, report.nodes);
+    TEST_ASSERT_EQUAL(node_size * 4u, report.total_bytes);
+    TEST_ASSERT_EQUAL(list.num_items * sizeof(int), report.item_bytes);
+    TEST_ASSERT_EQUAL((NODE_SIZE - 3u) * sizeof(int), report.unused_bytes);
+    TEST_ASSERT_EQUAL(report.total_bytes, report.header_bytes
+                      + report.item_bytes + report.unused_bytes);
+    TEST_ASSERT_EQUAL(1u, report.underfull_nodes);
+    TEST_ASSERT_EQUAL(3u, report.fill_histogram[ULIST_FILL_BUCKETS - 1u]);
+    TEST_ASSERT_EQUAL(1u, report.fill_histogram[3]);
+}
+
+void test_ulist_memory_report_after_deletion(void)
+{
+    _append(NODE_SIZE * 10);
+
+    // Remove items from the middle of every node
+    for (unsigned long long i = 0u; i < 10u; i++)
+    {
+        for (unsigned j = 0u; j < 4u; j++)
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK,
+                              ulist_pop_item(&list, (i * 6u) + 2u, NULL));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&list, &report));
+    TEST_ASSERT_EQUAL(list.nodes, report.nodes);
+    TEST_ASSERT_EQUAL(list.num_items * sizeof(int), report.item_bytes);
+    TEST_ASSERT_EQUAL((list.nodes * NODE_SIZE - list.num_items) * sizeof(int),
+                      report.unused_bytes);
+
+    unsigned long long histogram_nodes = 0u;
+    for (unsigned i = 0u; i < ULIST_FILL_BUCKETS; i++)
+    {
+        histogram_nodes += report.fill_histogram[i];
+    }
+
+    TEST_ASSERT_EQUAL(report.nodes, histogram_nodes);
+    TEST_ASSERT_EQUAL(0u, report.fill_histogram[ULIST_FILL_BUCKETS - 1u]);
+}
+
+void test_ulist_memory_report_clone_shares_items(void)
+{
+    ulist_t clone;
+
+    _append(NODE_SIZE * 4);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clone(&list, &clone));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&clone, &report));
+    TEST_ASSERT_EQUAL(4u, report.nodes);
+    TEST_ASSERT_EQUAL(report.header_bytes, report.total_bytes);
+    TEST_ASSERT_EQUAL(0u, report.unused_bytes);
+    TEST_ASSERT_EQUAL(NODE_SIZE * 4u * sizeof(int), report.item_bytes);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&clone));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_memory_report_invalid_params);
+    RUN_TEST(test_ulist_memory_report_empty_list);
+    RUN_TEST(test_ulist_memory_report_full_nodes);
+    RUN_TEST(test_ulist_memory_report_after_deletion);
+    RUN_TEST(test_ulist_memory_report_clone_shares_items);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "ulist_mpmc_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_PRODUCERS (3)
+#define NUM_CONSUMERS (3)
+#define MAX_THREADS (NUM_PRODUCERS + NUM_CONSUMERS)
+#define ITEMS_PER_PRODUCER (50000)
+#define TOTAL_ITEMS (NUM_PRODUCERS * ITEMS_PER_PRODUCER)
+
+typedef struct {
+    int producer;
+    int seq;
+} tagged_t;
+
+typedef struct {
+    unsigned int id;
+    int count;
+} thread_args_t;
+
+static ulist_mpmc_t queue;
+static unsigned char _seen[TOTAL_ITEMS];
+static int _consumed;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_mpmc_create(&queue, sizeof(tagged_t),
+                                                 NODE_SIZE, MAX_THREADS));
+   memset(_seen, 0, sizeof(_seen));
+   _consumed = 0;
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_mpmc_destroy(&queue));
+}
+
+static void *_producer_thread(void *arg)
+{
+    thread_args_t *args = (thread_args_t *) arg;
+
+    for (int i = 0; i < ITEMS_PER_PRODUCER; i++)
+    {
+        tagged_t item = {.producer = args->id, .seq = i};
+
+        if (ULIST_OK != ulist_mpmc_push(&queue, args->id, &item))
+        {
+            return (void *) 1;
+        }
+    }
+
+    return NULL;
+}
+
+/* Pops until all items have been consumed. Items from each producer must be
+ * seen in the order they were pushed, and each item only once. */
+static void *_consumer_thread(void *arg)
+{
+    thread_args_t *args = (thread_args_t *) arg;
+    int last_seq[NUM_PRODUCERS];
+
+    for (int i = 0; i < NUM_PRODUCERS; i++)
+    {
+        last_seq[i] = -1;
+    }
+
+    while (__atomic_load_n(&_consumed, __ATOMIC_RELAXED) < TOTAL_ITEMS)
+    {
+        tagged_t item;
+        ulist_status_e err = ulist_mpmc_pop(&queue, args->id, &item);
+
+        if (ULIST_END == err)
+        {
+            continue;
+        }
+
+        if ((ULIST_OK != err) || (item.seq <= last_seq[item.producer]))
+        {
+            return (void *) 1;
+        }
+
+        int index = (item.producer * ITEMS_PER_PRODUCER) + item.seq;
+        if (__atomic_exchange_n(&_seen[index], 1u, __ATOMIC_RELAXED))
+        {
+            return (void *) 1;
+        }
+
+        last_seq[item.producer] = item.seq;
+        args->count += 1;
+        __atomic_add_fetch(&_consumed, 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+void test_mpmc_null(void)
+{
+    tagged_t item;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_create(NULL, sizeof(int), NODE_SIZE, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_push(NULL, 0u, &item));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_push(&queue, 0u, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_pop(NULL, 0u, &item));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_pop(&queue, 0u, NULL));
+}
+
+void test_mpmc_invalid_create(void)
+{
+    ulist_mpmc_t q;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_create(&q, 0u, NODE_SIZE, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_create(&q, sizeof(int), 1u, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_create(&q, sizeof(int), NODE_SIZE, 0u));
+}
+
+void test_mpmc_invalid_thread_id(void)
+{
+    tagged_t item = {0};
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_push(&queue, MAX_THREADS, &item));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_mpmc_pop(&queue, MAX_THREADS, &item));
+}
+
+void test_mpmc_single_thread_fifo(void)
+{
+    int num_items = 1000;
+    tagged_t item;
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_mpmc_pop(&queue, 0u, &item));
+
+    for (int i = 0; i < num_items; i++)
+    {
+        item.producer = 0;
+        item.seq = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_mpmc_push(&queue, 0u, &item));
+    }
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_mpmc_pop(&queue, 0u, &item));
+        TEST_ASSERT_EQUAL(i, item.seq);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_mpmc_pop(&queue, 0u, &item));
+}
+
+void test_mpmc_many_threads(void)
+{
+    pthread_t threads[MAX_THREADS];
+    thread_args_t args[MAX_THREADS];
+    void *ret;
+    int total = 0;
+
+    for (int i = 0; i < MAX_THREADS; i++)
+    {
+        args[i].id = i;
+        args[i].count = 0;
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL,
+            (i < NUM_PRODUCERS) ? _producer_thread : _consumer_thread, &args[i]));
+    }
+
+    for (int i = 0; i < MAX_THREADS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_join(threads[i], &ret));
+        TEST_ASSERT_NULL(ret);
+        total += args[i].count;
+    }
+
+    TEST_ASSERT_EQUAL(TOTAL_ITEMS, total);
+
+    for (int i = 0; i < TOTAL_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(1, _seen[i]);
+    }
+
+    tagged_t item;
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_mpmc_pop(&queue, 0u, &item));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_mpmc_null);
+    RUN_TEST(test_mpmc_invalid_create);
+    RUN_TEST(test_mpmc_invalid_thread_id);
+    RUN_TEST(test_mpmc_single_thread_fifo);
+    RUN_TEST(test_mpmc_many_threads);
+    return UNITY_END();
+}
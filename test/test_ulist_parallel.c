@@ -0,0 +1,336 @@
+#include <string.h>
+#include <limits.h>
+
+#include "unity.h"
+
+#include "ulist_parallel_api.h"
+
+#define NODE_SIZE (16u)
+#define NUM_ITEMS (5000)
+#define CHUNK_ITEMS (100u)
+#define NUM_CHUNKS ((NUM_ITEMS + CHUNK_ITEMS - 1u) / CHUNK_ITEMS)
+#define MAX_THREADS (8u)
+
+static ulist_t list;
+static unsigned char _visits[NUM_ITEMS];
+static unsigned long long _chunk_sums[NUM_CHUNKS];
+static unsigned int _span_errors;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+   memset(_visits, 0, sizeof(_visits));
+   memset(_chunk_sums, 0, sizeof(_chunk_sums));
+   _span_errors = 0u;
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _fill(int num_items)
+{
+    // Insert in the middle, so nodes are not all full
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    for (int i = 0; i < num_items; i += 7)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, i, &val));
+    }
+}
+
+// Marks each visited index, and checks items match their index
+static void _mark_span(const ulist_span_t *span, void *ctx)
+{
+    int *items = (int *) span->items;
+    (void) ctx;
+
+    for (size_t i = 0u; i < span->count; i++)
+    {
+        if (items[i] != (int) (span->index + i))
+        {
+            __atomic_fetch_add(&_span_errors, 1u, __ATOMIC_RELAXED);
+        }
+
+        _visits[span->index + i] += 1u;
+    }
+}
+
+// Sums items per chunk, and checks spans don't cross chunk boundaries
+static void _sum_chunk(const ulist_span_t *span, void *ctx)
+{
+    int *items = (int *) span->items;
+    unsigned long long *sums = (unsigned long long *) ctx;
+
+    if ((span->index / CHUNK_ITEMS != span->chunk)
+        || ((span->index + span->count - 1u) / CHUNK_ITEMS != span->chunk))
+    {
+        __atomic_fetch_add(&_span_errors, 1u, __ATOMIC_RELAXED);
+    }
+
+    for (size_t i = 0u; i < span->count; i++)
+    {
+        sums[span->chunk] = (sums[span->chunk] * 31u) + (unsigned) items[i];
+    }
+}
+
+// Accumulator for the reduce tests
+typedef struct {
+    long long sum;
+    int min;
+    int max;
+    int first;
+    int last;
+    int ordered;
+} stats_t;
+
+static void _stats_init(void *acc, void *ctx)
+{
+    stats_t *stats = (stats_t *) acc;
+    (void) ctx;
+
+    stats->sum = 0;
+    stats->min = INT_MAX;
+    stats->max = INT_MIN;
+    stats->first = -1;
+    stats->last = -1;
+    stats->ordered = 1;
+}
+
+static void _stats_accumulate(void *acc, const ulist_span_t *span, void *ctx)
+{
+    stats_t *stats = (stats_t *) acc;
+    int *items = (int *) span->items;
+    (void) ctx;
+
+    for (size_t i = 0u; i < span->count; i++)
+    {
+        stats->sum += items[i];
+        stats->min = (items[i] < stats->min) ? items[i] : stats->min;
+        stats->max = (items[i] > stats->max) ? items[i] : stats->max;
+
+        if (stats->first < 0)
+        {
+            stats->first = items[i];
+        }
+        else if (items[i] != (stats->last + 1))
+        {
+            stats->ordered = 0;
+        }
+
+        stats->last = items[i];
+    }
+}
+
+// Not commutative; partials must be combined in list order
+static void _stats_combine(void *acc, const void *partial, void *ctx)
+{
+    stats_t *stats = (stats_t *) acc;
+    const stats_t *part = (const stats_t *) partial;
+    (void) ctx;
+
+    stats->sum += part->sum;
+    stats->min = (part->min < stats->min) ? part->min : stats->min;
+    stats->max = (part->max > stats->max) ? part->max : stats->max;
+
+    if (stats->first < 0)
+    {
+        *stats = *part;
+        return;
+    }
+
+    stats->ordered &= part->ordered && (part->first == (stats->last + 1));
+    stats->last = part->last;
+}
+
+void test_parallel_null(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_for_each(NULL, _mark_span, NULL, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_for_each(&list, NULL, NULL, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_for_each(&list, _mark_span, NULL, 0u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_for_each_chunked(&list, _mark_span, NULL,
+                                                      1u, 0u));
+
+    stats_t stats;
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_reduce(NULL, _stats_init,
+                                            _stats_accumulate, _stats_combine,
+                                            NULL, sizeof(stats), &stats, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_reduce(&list, _stats_init,
+                                            _stats_accumulate, NULL,
+                                            NULL, sizeof(stats), &stats, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_reduce(&list, _stats_init,
+                                            _stats_accumulate, _stats_combine,
+                                            NULL, sizeof(stats), NULL, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_parallel_reduce(&list, _stats_init,
+                                            _stats_accumulate, _stats_combine,
+                                            NULL, 0u, &stats, 1u));
+}
+
+void test_parallel_empty(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_parallel_for_each(&list, _mark_span, NULL, 4u));
+}
+
+void test_parallel_visits_all(void)
+{
+    _fill(NUM_ITEMS);
+
+    for (unsigned int n = 1u; n <= MAX_THREADS; n++)
+    {
+        memset(_visits, 0, sizeof(_visits));
+        TEST_ASSERT_EQUAL(ULIST_OK,
+                          ulist_parallel_for_each(&list, _mark_span, NULL, n));
+
+        for (int i = 0; i < NUM_ITEMS; i++)
+        {
+            TEST_ASSERT_EQUAL(1u, _visits[i]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0u, _span_errors);
+}
+
+void test_parallel_more_threads_than_items(void)
+{
+    _fill(3);
+
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_parallel_for_each(&list, _mark_span, NULL, 16u));
+
+    for (int i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL(1u, _visits[i]);
+    }
+
+    TEST_ASSERT_EQUAL(0u, _span_errors);
+}
+
+// Counts the spans of each range
+static void _count_range(const ulist_span_t *span, void *ctx)
+{
+    unsigned *ranges = (unsigned *) ctx;
+
+    if (span->chunk >= ULIST_PARALLEL_MAX_THREADS)
+    {
+        __atomic_fetch_add(&_span_errors, 1u, __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_fetch_add(&ranges[span->chunk], 1u, __ATOMIC_RELAXED);
+}
+
+void test_parallel_thread_limits(void)
+{
+    unsigned ranges[ULIST_PARALLEL_MAX_THREADS] = {0};
+
+    // Too few items for a second thread; the caller does all the work
+    _fill(ULIST_PARALLEL_MIN_RANGE_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_parallel_for_each(&list, _count_range, ranges,
+                                              MAX_THREADS));
+    TEST_ASSERT_TRUE(ranges[0] > 0u);
+    TEST_ASSERT_EQUAL(0u, ranges[1]);
+
+    // Asking for more threads than allowed is capped, not an error
+    memset(_visits, 0, sizeof(_visits));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 0u));
+    _fill(NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_parallel_for_each(&list, _mark_span, NULL,
+                                              UINT_MAX));
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(1u, _visits[i]);
+    }
+
+    TEST_ASSERT_EQUAL(0u, _span_errors);
+}
+
+void test_parallel_chunked_deterministic(void)
+{
+    unsigned long long expected[NUM_CHUNKS];
+
+    _fill(NUM_ITEMS);
+
+    memset(expected, 0, sizeof(expected));
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_parallel_for_each_chunked(&list, _sum_chunk,
+                                                      expected, 1u,
+                                                      CHUNK_ITEMS));
+
+    for (unsigned int n = 2u; n <= MAX_THREADS; n++)
+    {
+        memset(_chunk_sums, 0, sizeof(_chunk_sums));
+        TEST_ASSERT_EQUAL(ULIST_OK,
+                          ulist_parallel_for_each_chunked(&list, _sum_chunk,
+                                                          _chunk_sums, n,
+                                                          CHUNK_ITEMS));
+        TEST_ASSERT_EQUAL_MEMORY(expected, _chunk_sums, sizeof(expected));
+    }
+
+    TEST_ASSERT_EQUAL(0u, _span_errors);
+}
+
+void test_parallel_reduce_empty(void)
+{
+    stats_t stats;
+
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_parallel_reduce(&list, _stats_init,
+                                            _stats_accumulate, _stats_combine,
+                                            NULL, sizeof(stats), &stats, 4u));
+    TEST_ASSERT_EQUAL(0, stats.sum);
+    TEST_ASSERT_EQUAL(-1, stats.first);
+}
+
+void test_parallel_reduce(void)
+{
+    _fill(NUM_ITEMS);
+
+    for (unsigned int n = 1u; n <= MAX_THREADS; n++)
+    {
+        stats_t stats;
+
+        TEST_ASSERT_EQUAL(ULIST_OK,
+                          ulist_parallel_reduce(&list, _stats_init,
+                                                _stats_accumulate,
+                                                _stats_combine, NULL,
+                                                sizeof(stats), &stats, n));
+        TEST_ASSERT_EQUAL((NUM_ITEMS * (NUM_ITEMS - 1LL)) / 2LL, stats.sum);
+        TEST_ASSERT_EQUAL(0, stats.min);
+        TEST_ASSERT_EQUAL(NUM_ITEMS - 1, stats.max);
+        TEST_ASSERT_EQUAL(0, stats.first);
+        TEST_ASSERT_EQUAL(NUM_ITEMS - 1, stats.last);
+        TEST_ASSERT_EQUAL(1, stats.ordered);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_parallel_null);
+    RUN_TEST(test_parallel_empty);
+    RUN_TEST(test_parallel_visits_all);
+    RUN_TEST(test_parallel_more_threads_than_items);
+    RUN_TEST(test_parallel_thread_limits);
+    RUN_TEST(test_parallel_chunked_deterministic);
+    RUN_TEST(test_parallel_reduce_empty);
+    RUN_TEST(test_parallel_reduce);
+    return UNITY_END();
+}
@@ -0,0 +1,217 @@
+#include <string.h>
+
+#include "unity.h"
+
+#include "ulist_pv_api.h"
+
+#define NODE_SIZE (4u)
+#define NUM_ITEMS (2000)
+#define NUM_VERSIONS (200)
+
+static ulist_pv_t empty;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_create(&empty, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_release(&empty));
+}
+
+// Check that a version holds the same items as an array, in order
+static void _verify_items(ulist_pv_t *version, int *expected, int num_items)
+{
+    ulist_pv_iter_t iter;
+    int *item;
+
+    TEST_ASSERT_EQUAL(num_items, version->num_items);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_iter_init(version, &iter, 0u));
+
+    for (int i = 0; i < num_items; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_iter_next(&iter, (void **) &item));
+        TEST_ASSERT_EQUAL(expected[i], *item);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_get_item(version, i, &val));
+        TEST_ASSERT_EQUAL(expected[i], val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_pv_iter_next(&iter, (void **) &item));
+}
+
+void test_pv_null(void)
+{
+    ulist_pv_t out;
+    int val = 0;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_create(NULL, 4u, 4u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_create(&out, 4u, 1u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_append_item(NULL, &val,
+                                                                &out));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_append_item(&empty, NULL,
+                                                                &out));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_append_item(&empty, &val,
+                                                                NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_get_item(&empty, 0u, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_release(NULL));
+}
+
+void test_pv_out_of_range(void)
+{
+    ulist_pv_t out;
+    int val = 0;
+
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_pv_get_item(&empty, 0u,
+                                                                  &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_pv_pop_item(&empty, 0u,
+                                                                  &val, &out));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_pv_set_item(&empty, 0u,
+                                                                  &val, &out));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_pv_insert_item(&empty, 1u, &val, &out));
+}
+
+void test_pv_versions_are_immutable(void)
+{
+    static int expected[NUM_VERSIONS + 1][NUM_VERSIONS];
+    ulist_pv_t versions[NUM_VERSIONS + 1];
+
+    versions[0] = empty;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_create(&empty, sizeof(int),
+                                                NODE_SIZE));
+
+    // Each version inserts one item in a different position
+    for (int v = 1; v <= NUM_VERSIONS; v++)
+    {
+        unsigned long long index = (unsigned long long) ((v * 37) + 11) % v;
+
+        memcpy(expected[v], expected[v - 1], sizeof(expected[v]));
+        memmove(&expected[v][index + 1u], &expected[v][index],
+                (v - 1 - index) * sizeof(int));
+        expected[v][index] = v;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_insert_item(&versions[v - 1],
+                                                         index, &v,
+                                                         &versions[v]));
+    }
+
+    for (int v = 0; v <= NUM_VERSIONS; v++)
+    {
+        _verify_items(&versions[v], expected[v], v);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_release(&versions[v]));
+    }
+}
+
+void test_pv_pop_and_set(void)
+{
+    static int expected[NUM_ITEMS];
+    ulist_pv_t version;
+    ulist_pv_t before;
+    int num_items = NUM_ITEMS;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_create(&version, sizeof(int),
+                                                NODE_SIZE));
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        expected[i] = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_append_item(&version, &i,
+                                                         &version));
+    }
+
+    _verify_items(&version, expected, num_items);
+
+    // Keep a reference to the full version
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_set_item(&version, 0u, &expected[0],
+                                                  &before));
+
+    // Remove items from the start, end and middle, and negate others
+    while (num_items > 0)
+    {
+        unsigned long long index = (num_items % 3 == 0) ? num_items - 1
+                                 : (num_items % 3 == 1) ? num_items / 2 : 0u;
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_pop_item(&version, index, &val,
+                                                      &version));
+        TEST_ASSERT_EQUAL(expected[index], val);
+        memmove(&expected[index], &expected[index + 1u],
+                (num_items - 1 - index) * sizeof(int));
+        num_items -= 1;
+
+        if (num_items > 0)
+        {
+            val = -expected[num_items / 3];
+            expected[num_items / 3] = val;
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_set_item(&version,
+                                                          num_items / 3, &val,
+                                                          &version));
+        }
+
+        if (0 == (num_items % 97))
+        {
+            _verify_items(&version, expected, num_items);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0u, version.height);
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        expected[i] = i;
+    }
+
+    _verify_items(&before, expected, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_release(&version));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_release(&before));
+}
+
+void test_pv_from_list(void)
+{
+    static int expected[NUM_ITEMS];
+    ulist_pv_t version;
+    ulist_t list;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        expected[i] = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_from_list(&list, &version));
+
+    // List copies the shared nodes before modifying them
+    while (list.num_items > 0u)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, 0u, NULL));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+    _verify_items(&version, expected, NUM_ITEMS);
+
+    // Edits to a version built from a list work like any other
+    int val = -1;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_insert_item(&version, 0u, &val,
+                                                     &version));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_pop_item(&version, 0u, &val,
+                                                  &version));
+    TEST_ASSERT_EQUAL(-1, val);
+    _verify_items(&version, expected, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pv_release(&version));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_pv_null);
+    RUN_TEST(test_pv_out_of_range);
+    RUN_TEST(test_pv_versions_are_immutable);
+    RUN_TEST(test_pv_pop_and_set);
+    RUN_TEST(test_pv_from_list);
+    return UNITY_END();
+}
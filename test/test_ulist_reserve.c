@@ -0,0 +1,135 @@
+#include "unity.h"
+
+#include "ulist_api.h"
+
+#define NODE_SIZE (8u)
+
+static ulist_t list;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static int _is_spare(ulist_node_t **spares, unsigned count, ulist_node_t *node)
+{
+    for (unsigned i = 0u; i < count; i++)
+    {
+        if (spares[i] == node)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void test_ulist_reserve_invalid_params(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_reserve(NULL, 10u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_shrink(NULL));
+}
+
+void test_ulist_reserve_fits_in_tail(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, NODE_SIZE));
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, NODE_SIZE + 1u));
+    TEST_ASSERT_EQUAL(1u, list.spare_nodes);
+}
+
+void test_ulist_reserve_appends_use_spare_nodes(void)
+{
+    ulist_node_t *spares[5];
+    unsigned long long num_items = (NODE_SIZE * 5u) + 3u;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, num_items));
+    TEST_ASSERT_EQUAL(5u, list.spare_nodes);
+
+    unsigned count = 0u;
+    for (ulist_node_t *node = list.spare; NULL != node; node = node->next)
+    {
+        spares[count++] = node;
+    }
+
+    // Reserving the same amount again doesn't add more nodes
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, num_items));
+    TEST_ASSERT_EQUAL(5u, list.spare_nodes);
+
+    for (int i = 0; i < (int) num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    TEST_ASSERT_NULL(list.spare);
+    TEST_ASSERT_EQUAL(6u, list.nodes);
+
+    for (ulist_node_t *node = list.head->next; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_TRUE(_is_spare(spares, count, node));
+    }
+
+    for (int i = 0; i < (int) num_items; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+}
+
+void test_ulist_reserve_inserts_use_spare_nodes(void)
+{
+    for (int i = 0; i < (int) NODE_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, 1u));
+    TEST_ASSERT_EQUAL(1u, list.spare_nodes);
+    ulist_node_t *spare = list.spare;
+
+    // Head is full, so this splits it into the spare node
+    int val = -1;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, 1u, &val));
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    TEST_ASSERT_EQUAL_PTR(spare, list.head->next);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, 1u, &val));
+    TEST_ASSERT_EQUAL(-1, val);
+}
+
+void test_ulist_shrink(void)
+{
+    ulist_memory_report_t report;
+    size_t node_size;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reserve(&list, NODE_SIZE * 4u));
+    TEST_ASSERT_EQUAL(3u, list.spare_nodes);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_node_size_bytes(&list, &node_size));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&list, &report));
+    TEST_ASSERT_EQUAL(3u, report.spare_nodes);
+    TEST_ASSERT_EQUAL(node_size * 4u, report.total_bytes);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_shrink(&list));
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    TEST_ASSERT_NULL(list.spare);
+    TEST_ASSERT_EQUAL(1u, list.nodes);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_reserve_invalid_params);
+    RUN_TEST(test_ulist_reserve_fits_in_tail);
+    RUN_TEST(test_ulist_reserve_appends_use_spare_nodes);
+    RUN_TEST(test_ulist_reserve_inserts_use_spare_nodes);
+    RUN_TEST(test_ulist_shrink);
+    return UNITY_END();
+}
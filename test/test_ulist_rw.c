@@ -0,0 +1,209 @@
+#include <pthread.h>
+
+#include "unity.h"
+
+#include "ulist_rw_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_ITEMS (2000)
+#define NUM_READERS (4)
+
+static ulist_rw_t list;
+static volatile int _writer_done;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_create(&list, sizeof(int), NODE_SIZE));
+   _writer_done = 0;
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_destroy(&list));
+}
+
+// Appends NUM_ITEMS items, then pops all the even ones
+static void *_writer_thread(void *arg)
+{
+    (void) arg;
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        if (ULIST_OK != ulist_rw_append_item(&list, &i))
+        {
+            return (void *) 1;
+        }
+    }
+
+    for (int i = 0; i < (NUM_ITEMS / 2); i++)
+    {
+        if (ULIST_OK != ulist_rw_pop_item(&list, i, NULL))
+        {
+            return (void *) 1;
+        }
+    }
+
+    _writer_done = 1;
+    return NULL;
+}
+
+/* Iterates over the list until the writer is finished, checking that each
+ * iteration sees a list in a consistent (ascending) state */
+static void *_reader_thread(void *arg)
+{
+    (void) arg;
+    int done = 0;
+
+    while (!done)
+    {
+        ulist_rw_iter_t iter;
+        int last = -1;
+        const void *val;
+
+        done = _writer_done;
+
+        if (ULIST_OK != ulist_rw_iter_begin(&list, &iter, 0u))
+        {
+            return (void *) 1;
+        }
+
+        while (ULIST_OK == ulist_rw_iter_next(&iter, &val))
+        {
+            if (*(const int *)val <= last)
+            {
+                ulist_rw_iter_end(&iter);
+                return (void *) 1;
+            }
+
+            last = *(const int *)val;
+        }
+
+        ulist_rw_iter_end(&iter);
+    }
+
+    return NULL;
+}
+
+void test_rw_null(void)
+{
+    ulist_rw_iter_t iter;
+    unsigned long long num_items;
+    int val = 0;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_create(NULL, sizeof(int), NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_append_item(NULL, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_append_item(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_get_item(NULL, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_num_items(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_iter_begin(NULL, &iter, 0u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_num_items(&list, &num_items));
+    TEST_ASSERT_EQUAL(0u, num_items);
+}
+
+void test_rw_single_thread(void)
+{
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_insert_item(&list, i, &i));
+    }
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+
+    ulist_rw_iter_t iter;
+    const void *val;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_iter_begin(&list, &iter, NUM_ITEMS - 1));
+    for (int i = NUM_ITEMS - 1; i >= 0; i--)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_iter_previous(&iter, &val));
+        TEST_ASSERT_EQUAL(i, *(const int *)val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_rw_iter_previous(&iter, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_iter_end(&iter));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_rw_iter_end(&iter));
+
+    // Failing to start an iteration should not leave the read lock held
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, ulist_rw_iter_begin(&list, &iter, NUM_ITEMS));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_pop_item(&list, 0u, NULL));
+}
+
+void test_rw_concurrent_readers(void)
+{
+    pthread_t writer;
+    pthread_t readers[NUM_READERS];
+    void *ret;
+
+    for (int i = 0; i < NUM_READERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, _reader_thread, NULL));
+    }
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, _writer_thread, NULL));
+
+    TEST_ASSERT_EQUAL(0, pthread_join(writer, &ret));
+    TEST_ASSERT_NULL(ret);
+
+    for (int i = 0; i < NUM_READERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_join(readers[i], &ret));
+        TEST_ASSERT_NULL(ret);
+    }
+
+    unsigned long long num_items;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_num_items(&list, &num_items));
+    TEST_ASSERT_EQUAL(NUM_ITEMS / 2, num_items);
+
+    for (int i = 0; i < (NUM_ITEMS / 2); i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL((i * 2) + 1, val);
+    }
+}
+
+void test_rw_nested_lock(void)
+{
+#ifdef NDEBUG
+    TEST_IGNORE_MESSAGE("Nested lock checks are compiled out");
+#endif
+
+    ulist_rw_iter_t iter;
+    int val = 1;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_append_item(&list, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_iter_begin(&list, &iter, 0u));
+
+    // Nested locks on the same list are refused instead of deadlocking
+    unsigned long long num_items;
+    TEST_ASSERT_EQUAL(ULIST_ERROR_INTERNAL,
+                      ulist_rw_get_item(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_INTERNAL,
+                      ulist_rw_num_items(&list, &num_items));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_INTERNAL, ulist_rw_append_item(&list, &val));
+
+    // Other lists can still be read
+    ulist_rw_t other;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_create(&other, sizeof(int), 4u));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_num_items(&other, &num_items));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_destroy(&other));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_iter_end(&iter));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_get_item(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_append_item(&list, &val));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rw_null);
+    RUN_TEST(test_rw_single_thread);
+    RUN_TEST(test_rw_concurrent_readers);
+    RUN_TEST(test_rw_nested_lock);
+    return UNITY_END();
+}
@@ -0,0 +1,275 @@
+#include <pthread.h>
+
+#include "unity.h"
+
+#include "ulist_snapshot_api.h"
+#include "ulist_typed_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_ITEMS (500)
+#define NUM_READERS (3)
+
+ULIST_DEFINE(intlist, int, NODE_SIZE)
+
+static ulist_t list;
+static ulist_rw_t rw;
+static volatile int _writer_done;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+   _writer_done = 0;
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _fill(ulist_t *l, int num_items)
+{
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(l, &i));
+    }
+}
+
+// Check that a snapshot holds the items 0 to num_items - 1, in order
+static void _verify_snapshot(ulist_snapshot_t *snapshot, int num_items)
+{
+    ulist_snapshot_iter_t iter;
+    int *item;
+    int val;
+
+    TEST_ASSERT_EQUAL(num_items, snapshot->num_items);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_iter_init(snapshot, &iter, 0u));
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_iter_next(&iter,
+                                                             (void **) &item));
+        TEST_ASSERT_EQUAL(i, *item);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_get_item(snapshot, i, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_snapshot_iter_next(&iter,
+                                                          (void **) &item));
+}
+
+void test_snapshot_null(void)
+{
+    ulist_snapshot_t snapshot;
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_snapshot_acquire(NULL,
+                                                                  &snapshot));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_snapshot_acquire(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_snapshot_release(NULL));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &snapshot));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_snapshot_get_item(&snapshot, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_snapshot_release(&snapshot));
+}
+
+void test_snapshot_stable_under_writes(void)
+{
+    ulist_snapshot_t snapshot;
+
+    _fill(&list, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &snapshot));
+
+    // Modify the list at the head, tail and in the middle
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        int val = -i;
+        unsigned long long index = (unsigned long long) (i * 7) % list.num_items;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, index, &val));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &val));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, 0u, NULL));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, list.num_items / 2u,
+                                                   NULL));
+    }
+
+    _verify_snapshot(&snapshot, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+}
+
+void test_snapshot_list_unchanged_by_cow(void)
+{
+    ulist_snapshot_t snapshot;
+
+    _fill(&list, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &snapshot));
+
+    // Pop every other item; list should only be left with odd items
+    for (int i = 0; i < (NUM_ITEMS / 2); i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, i, NULL));
+    }
+
+    for (int i = 0; i < (NUM_ITEMS / 2); i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL((i * 2) + 1, val);
+    }
+
+    _verify_snapshot(&snapshot, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+}
+
+void test_snapshot_multiple_epochs(void)
+{
+    ulist_snapshot_t first;
+    ulist_snapshot_t second;
+
+    _fill(&list, NUM_ITEMS / 2);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &first));
+
+    for (int i = NUM_ITEMS / 2; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &second));
+
+    while (list.num_items > 0u)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, 0u, NULL));
+    }
+
+    // Release in acquisition order, checking the other is intact
+    _verify_snapshot(&first, NUM_ITEMS / 2);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&first));
+    _verify_snapshot(&second, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&second));
+}
+
+void test_snapshot_outlives_list(void)
+{
+    ulist_snapshot_t snapshot;
+    ulist_t other;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&other, sizeof(int), NODE_SIZE));
+    _fill(&other, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&other, &snapshot));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&other));
+
+    _verify_snapshot(&snapshot, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+}
+
+void test_snapshot_typed_fast_paths(void)
+{
+    ulist_snapshot_t snapshot;
+    intlist_t typed;
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_create(&typed));
+
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_append(&typed, i));
+    }
+
+    // Tail node is shared, so appends and pops must not modify it in place
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&typed.list, &snapshot));
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_append(&typed, 99));
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_pop(&typed, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_pop(&typed, 3u, &val));
+    TEST_ASSERT_EQUAL(99, val);
+
+    _verify_snapshot(&snapshot, 4);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_destroy(&typed));
+}
+
+// Repeatedly takes snapshots and scans them without holding any lock
+static void *_reader_thread(void *arg)
+{
+    (void) arg;
+
+    while (!_writer_done)
+    {
+        ulist_snapshot_t snapshot;
+        ulist_snapshot_iter_t iter;
+        int *item;
+        int last = -1;
+
+        if (ULIST_OK != ulist_rw_snapshot_acquire(&rw, &snapshot))
+        {
+            return (void *) 1;
+        }
+
+        if (ULIST_OK != ulist_snapshot_iter_init(&snapshot, &iter, 0u))
+        {
+            return (void *) 1;
+        }
+
+        // Writer only ever adds and removes items in increasing order
+        while (ULIST_OK == ulist_snapshot_iter_next(&iter, (void **) &item))
+        {
+            if (*item <= last)
+            {
+                return (void *) 1;
+            }
+
+            last = *item;
+        }
+
+        ulist_snapshot_release(&snapshot);
+    }
+
+    return NULL;
+}
+
+void test_snapshot_concurrent_readers(void)
+{
+    pthread_t readers[NUM_READERS];
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_create(&rw, sizeof(int), NODE_SIZE));
+
+    for (int i = 0; i < NUM_READERS; i++)
+    {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, _reader_thread,
+                                            NULL));
+    }
+
+    for (int i = 0; i < NUM_ITEMS * 4; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_append_item(&rw, &i));
+
+        if (0 == (i % 3))
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_pop_item(&rw, i / 5, NULL));
+        }
+    }
+
+    _writer_done = 1;
+
+    for (int i = 0; i < NUM_READERS; i++)
+    {
+        void *ret;
+        TEST_ASSERT_EQUAL(0, pthread_join(readers[i], &ret));
+        TEST_ASSERT_NULL(ret);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_rw_destroy(&rw));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshot_null);
+    RUN_TEST(test_snapshot_stable_under_writes);
+    RUN_TEST(test_snapshot_list_unchanged_by_cow);
+    RUN_TEST(test_snapshot_multiple_epochs);
+    RUN_TEST(test_snapshot_outlives_list);
+    RUN_TEST(test_snapshot_typed_fast_paths);
+    RUN_TEST(test_snapshot_concurrent_readers);
+    return UNITY_END();
+}
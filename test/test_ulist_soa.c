@@ -0,0 +1,293 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+
+#include "ulist_soa_api.h"
+
+#define NODE_SIZE (16u)
+#define NUM_RECORDS (1000u)
+
+// Packed record: 8-byte timestamp, 2-byte tag, 20-byte payload
+#define RECORD_BYTES (30u)
+
+static const size_t fields[] = {8u, 2u, 20u};
+static ulist_soa_t soa;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_create(&soa, fields, 3u, NODE_SIZE));
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_destroy(&soa));
+}
+
+static void _make_record(unsigned key, char *record)
+{
+    uint64_t timestamp = key;
+    uint16_t tag = (uint16_t) (key * 7u);
+
+    memcpy(record, &timestamp, sizeof(timestamp));
+    memcpy(record + 8u, &tag, sizeof(tag));
+    memset(record + 10u, (int) (key & 0xffu), 20u);
+}
+
+static void _check_record(unsigned long long index, unsigned key)
+{
+    char expected[RECORD_BYTES];
+    char record[RECORD_BYTES];
+
+    _make_record(key, expected);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_get(&soa, index, record));
+    TEST_ASSERT_EQUAL(0, memcmp(expected, record, RECORD_BYTES));
+}
+
+void test_ulist_soa_invalid_params(void)
+{
+    ulist_soa_t other;
+    size_t bad_fields[] = {8u, 0u};
+    ulist_soa_iter_t iter;
+    char record[RECORD_BYTES];
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_soa_create(NULL, fields, 3u, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_soa_create(&other, fields, 0u, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_soa_create(&other, fields,
+                                       ULIST_SOA_MAX_FIELDS + 1u, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_soa_create(&other, bad_fields, 2u, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_soa_append(&soa, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_soa_iter_init(&soa, &iter,
+                                                               3u));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_soa_get(&soa, 0u, record));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE,
+                      ulist_soa_insert(&soa, 1u, record));
+}
+
+void test_ulist_soa_append_get(void)
+{
+    char record[RECORD_BYTES];
+
+    for (unsigned i = 0u; i < NUM_RECORDS; i++)
+    {
+        _make_record(i, record);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_append(&soa, record));
+    }
+
+    TEST_ASSERT_EQUAL(NUM_RECORDS, soa.list.num_items);
+    TEST_ASSERT_EQUAL((NUM_RECORDS + NODE_SIZE - 1u) / NODE_SIZE,
+                      soa.list.nodes);
+
+    for (unsigned i = 0u; i < NUM_RECORDS; i++)
+    {
+        _check_record(i, i);
+    }
+}
+
+void test_ulist_soa_field_columns(void)
+{
+    char record[RECORD_BYTES];
+    ulist_soa_iter_t iter;
+    void *items;
+    size_t count;
+
+    for (unsigned i = 0u; i < NUM_RECORDS; i++)
+    {
+        _make_record(i, record);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_append(&soa, record));
+    }
+
+    // Timestamps are contiguous within each node
+    unsigned long long seen = 0u;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_iter_init(&soa, &iter, 0u));
+
+    while (ULIST_OK == ulist_soa_iter_next(&iter, &items, &count))
+    {
+        uint64_t *timestamps = items;
+
+        for (size_t j = 0u; j < count; j++)
+        {
+            TEST_ASSERT_EQUAL(seen + j, timestamps[j]);
+        }
+
+        seen += count;
+    }
+
+    TEST_ASSERT_EQUAL(NUM_RECORDS, seen);
+
+    // Tags too
+    seen = 0u;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_iter_init(&soa, &iter, 1u));
+
+    while (ULIST_OK == ulist_soa_iter_next(&iter, &items, &count))
+    {
+        uint16_t *tags = items;
+
+        for (size_t j = 0u; j < count; j++)
+        {
+            TEST_ASSERT_EQUAL((uint16_t) ((seen + j) * 7u), tags[j]);
+        }
+
+        seen += count;
+    }
+
+    TEST_ASSERT_EQUAL(NUM_RECORDS, seen);
+}
+
+void test_ulist_soa_aligned_columns(void)
+{
+    // A 1-byte field and an odd node size would misalign a packed layout
+    static const size_t flag_fields[] = {1u, 8u};
+    ulist_soa_t other;
+    ulist_soa_iter_t iter;
+    void *items;
+    size_t count;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_create(&other, flag_fields, 2u, 7u));
+
+    for (unsigned i = 0u; i < 100u; i++)
+    {
+        char record[9];
+        uint64_t value = (uint64_t) i * 3u;
+
+        record[0] = (char) i;
+        memcpy(record + 1u, &value, sizeof(value));
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_insert(&other, i / 2u, record));
+    }
+
+    for (size_t f = 0u; f < 2u; f++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_iter_init(&other, &iter, f));
+
+        while (ULIST_OK == ulist_soa_iter_next(&iter, &items, &count))
+        {
+            TEST_ASSERT_EQUAL(0u, (uintptr_t) items % ULIST_SOA_COLUMN_ALIGN);
+        }
+    }
+
+    // Values read through the column match the records
+    unsigned long long index = 0u;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_iter_init(&other, &iter, 1u));
+
+    while (ULIST_OK == ulist_soa_iter_next(&iter, &items, &count))
+    {
+        uint64_t *values = items;
+
+        for (size_t j = 0u; j < count; j++)
+        {
+            char record[9];
+            uint64_t value;
+
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_get(&other, index + j,
+                                                      record));
+            memcpy(&value, record + 1u, sizeof(value));
+            TEST_ASSERT_EQUAL(value, values[j]);
+            TEST_ASSERT_EQUAL((uint64_t) (unsigned char) record[0] * 3u,
+                              values[j]);
+        }
+
+        index += count;
+    }
+
+    TEST_ASSERT_EQUAL(100u, index);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_destroy(&other));
+}
+
+void test_ulist_soa_iter_empty(void)
+{
+    ulist_soa_iter_t iter;
+    void *items;
+    size_t count;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_iter_init(&soa, &iter, 2u));
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_soa_iter_next(&iter, &items, &count));
+}
+
+void test_ulist_soa_random_edits(void)
+{
+    static unsigned keys[NUM_RECORDS];
+    unsigned long long num_records = 0u;
+    char record[RECORD_BYTES];
+
+    for (unsigned i = 0u; i < (8u * NUM_RECORDS); i++)
+    {
+        unsigned long long index = (unsigned) rand() % (num_records + 1u);
+
+        if ((num_records < NUM_RECORDS)
+            && ((0u == num_records) || (rand() & 1)))
+        {
+            unsigned key = (unsigned) rand();
+
+            _make_record(key, record);
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_insert(&soa, index, record));
+            memmove(&keys[index + 1u], &keys[index],
+                    (num_records - index) * sizeof(unsigned));
+            keys[index] = key;
+            num_records += 1u;
+        }
+        else
+        {
+            char expected[RECORD_BYTES];
+
+            index %= num_records;
+            _make_record(keys[index], expected);
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_pop(&soa, index, record));
+            TEST_ASSERT_EQUAL(0, memcmp(expected, record, RECORD_BYTES));
+            memmove(&keys[index], &keys[index + 1u],
+                    (num_records - index - 1u) * sizeof(unsigned));
+            num_records -= 1u;
+        }
+    }
+
+    TEST_ASSERT_EQUAL(num_records, soa.list.num_items);
+
+    for (unsigned long long i = 0u; i < num_records; i++)
+    {
+        _check_record(i, keys[i]);
+    }
+
+    // Nodes stay at least half full, apart from the ends
+    for (ulist_node_t *node = soa.list.head->next;
+         (NULL != node) && (soa.list.tail != node); node = node->next)
+    {
+        TEST_ASSERT_TRUE(node->used >= (NODE_SIZE / 2u));
+    }
+}
+
+void test_ulist_soa_pop_all(void)
+{
+    char record[RECORD_BYTES];
+
+    for (unsigned i = 0u; i < NUM_RECORDS; i++)
+    {
+        _make_record(i, record);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_append(&soa, record));
+    }
+
+    for (unsigned i = 0u; i < NUM_RECORDS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_soa_pop(&soa, 0u, record));
+        TEST_ASSERT_EQUAL(i, *(uint64_t *) record);
+    }
+
+    TEST_ASSERT_EQUAL(0u, soa.list.num_items);
+    TEST_ASSERT_EQUAL(1u, soa.list.nodes);
+}
+
+int main(int argc, char *argv[])
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_soa_invalid_params);
+    RUN_TEST(test_ulist_soa_append_get);
+    RUN_TEST(test_ulist_soa_field_columns);
+    RUN_TEST(test_ulist_soa_aligned_columns);
+    RUN_TEST(test_ulist_soa_iter_empty);
+    RUN_TEST(test_ulist_soa_random_edits);
+    RUN_TEST(test_ulist_soa_pop_all);
+    return UNITY_END();
+}
@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "unity.h"
+
+#include "ulist_spill_api.h"
+#include "ulist_io_api.h"
+#include "ulist_pv_api.h"
+#include "ulist_snapshot_api.h"
+
+#define NODE_SIZE (8u)
+#define MAX_RESIDENT (6u)
+#define NUM_ITEMS (1000)
+
+static ulist_t list;
+static FILE *file;
+static int expected[NUM_ITEMS * 2];
+static unsigned long long num_expected;
+
+void setUp(void)
+{
+   TEST_ASSERT_NOT_NULL(file = tmpfile());
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_spill_create(&list, sizeof(int),
+                     NODE_SIZE, fileno(file),
+                     MAX_RESIDENT * NODE_SIZE * sizeof(int)));
+   num_expected = 0u;
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+   fclose(file);
+}
+
+static void _insert(unsigned long long index, int val)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, index, &val));
+
+    for (unsigned long long i = num_expected; i > index; i--)
+    {
+        expected[i] = expected[i - 1u];
+    }
+
+    expected[index] = val;
+    num_expected += 1u;
+}
+
+static void _pop(unsigned long long index)
+{
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, index, &val));
+    TEST_ASSERT_EQUAL(expected[index], val);
+
+    for (unsigned long long i = index; (i + 1u) < num_expected; i++)
+    {
+        expected[i] = expected[i + 1u];
+    }
+
+    num_expected -= 1u;
+}
+
+static void _verify(void)
+{
+    ulist_spill_stats_t stats;
+
+    TEST_ASSERT_EQUAL(num_expected, list.num_items);
+
+    for (unsigned long long i = 0u; i < num_expected; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(expected[i], val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_spill_get_stats(&list, &stats));
+    TEST_ASSERT_TRUE(stats.resident_nodes <= MAX_RESIDENT);
+}
+
+void test_ulist_spill_create_invalid_params(void)
+{
+    ulist_t other;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_spill_create(NULL, sizeof(int), NODE_SIZE,
+                                         fileno(file), 0u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_spill_create(&other, 0u, NODE_SIZE,
+                                         fileno(file), 0u));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_spill_create(&other, sizeof(int), NODE_SIZE,
+                                         -1, 0u));
+}
+
+void test_ulist_spill_append_evicts_and_loads(void)
+{
+    ulist_spill_stats_t stats;
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+        expected[num_expected++] = i;
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_spill_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(MAX_RESIDENT, stats.max_resident_nodes);
+    TEST_ASSERT_TRUE(stats.evictions > 0u);
+    TEST_ASSERT_EQUAL(0u, stats.loads);
+
+    _verify();
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_spill_get_stats(&list, &stats));
+    TEST_ASSERT_TRUE(stats.loads > 0u);
+    TEST_ASSERT_TRUE(stats.file_slots <= list.nodes);
+}
+
+void test_ulist_spill_random_insert_pop(void)
+{
+    srand(1234);
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        _insert((unsigned long long) rand() % (num_expected + 1u), i);
+    }
+
+    _verify();
+
+    for (int i = 0; i < (NUM_ITEMS / 2); i++)
+    {
+        _pop((unsigned long long) rand() % num_expected);
+
+        if (0 == (i % 2))
+        {
+            _insert((unsigned long long) rand() % (num_expected + 1u), -i);
+        }
+    }
+
+    _verify();
+
+    while (num_expected > 0u)
+    {
+        _pop((unsigned long long) rand() % num_expected);
+    }
+
+    _verify();
+    TEST_ASSERT_EQUAL(1u, list.nodes);
+}
+
+void test_ulist_spill_set_item_through_pointer(void)
+{
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        _insert(num_expected, i);
+    }
+
+    for (unsigned long long i = 0u; i < num_expected; i += 7u)
+    {
+        void *item;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item_pointer(&list, i, &item));
+        *(int *) item = -1;
+        expected[i] = -1;
+
+        // Touch the other end of the list so the node gets evicted
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item_pointer(&list,
+                          num_expected - 1u - i, &item));
+    }
+
+    _verify();
+}
+
+void test_ulist_spill_iterate(void)
+{
+    ulist_iter_t iter;
+    const void *val;
+    void *item;
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        _insert(num_expected, i);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_init(&list, &iter, 0u));
+
+    for (unsigned long long i = 0u; i < num_expected; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_iter_next(&iter, &val));
+        TEST_ASSERT_EQUAL(expected[i], *(const int *) val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_iter_next(&iter, &val));
+
+    TEST_ASSERT_EQUAL(ULIST_OK,
+                      ulist_set_iteration_start_index(&list, num_expected - 1u));
+
+    for (unsigned long long i = num_expected; i > 0u; i--)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_previous_item(&list, &item));
+        TEST_ASSERT_EQUAL(expected[i - 1u], *(int *) item);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_get_previous_item(&list, &item));
+}
+
+void test_ulist_spill_clear(void)
+{
+    ulist_spill_stats_t stats;
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        _insert(num_expected, i);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 10u));
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_spill_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(1u, stats.resident_nodes);
+    num_expected = 0u;
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        _insert(num_expected, -i);
+    }
+
+    _verify();
+}
+
+void test_ulist_spill_other_modules_reject(void)
+{
+    ulist_t clone;
+    ulist_pv_t version;
+    ulist_snapshot_t snapshot;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_clone(&list, &clone));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_pv_from_list(&list, &version));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_snapshot_acquire(&list, &snapshot));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_save(&list, fileno(file)));
+}
+
+void test_ulist_spill_get_stats_invalid_params(void)
+{
+    ulist_t regular;
+    ulist_spill_stats_t stats;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&regular, sizeof(int), NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spill_get_stats(NULL, &stats));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spill_get_stats(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_spill_get_stats(&regular, &stats));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&regular));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_spill_create_invalid_params);
+    RUN_TEST(test_ulist_spill_append_evicts_and_loads);
+    RUN_TEST(test_ulist_spill_random_insert_pop);
+    RUN_TEST(test_ulist_spill_set_item_through_pointer);
+    RUN_TEST(test_ulist_spill_iterate);
+    RUN_TEST(test_ulist_spill_clear);
+    RUN_TEST(test_ulist_spill_other_modules_reject);
+    RUN_TEST(test_ulist_spill_get_stats_invalid_params);
+    return UNITY_END();
+}
@@ -0,0 +1,139 @@
+#include <pthread.h>
+
+#include "unity.h"
+
+#include "ulist_spsc_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_ITEMS (200000)
+
+static ulist_spsc_t queue;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_create(&queue, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_destroy(&queue));
+}
+
+static void *_producer_thread(void *arg)
+{
+    (void) arg;
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        if (ULIST_OK != ulist_spsc_push(&queue, &i))
+        {
+            return (void *) 1;
+        }
+    }
+
+    return NULL;
+}
+
+void test_spsc_null(void)
+{
+    int val = 0;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spsc_create(NULL, sizeof(int), NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spsc_push(NULL, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spsc_push(&queue, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spsc_pop(NULL, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_spsc_pop(&queue, NULL));
+}
+
+void test_spsc_empty(void)
+{
+    int val = 1;
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_spsc_pop(&queue, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_push(&queue, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_pop(&queue, &val));
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_spsc_pop(&queue, &val));
+}
+
+void test_spsc_fifo_order(void)
+{
+    int num_items = 1000;
+    int val;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_push(&queue, &i));
+    }
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_pop(&queue, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, ulist_spsc_pop(&queue, &val));
+}
+
+void test_spsc_nodes_recycled(void)
+{
+    int val;
+
+    // Keep a few nodes worth of items in the queue
+    for (int i = 0; i < (NODE_SIZE * 3); i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_push(&queue, &i));
+    }
+
+    unsigned long long nodes = queue.list.nodes;
+
+    // Once drained nodes are available, no more nodes should be allocated
+    for (int i = 0; i < 10000; i++)
+    {
+        int expected = i;
+        int push_val = i + (NODE_SIZE * 3);
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_pop(&queue, &val));
+        TEST_ASSERT_EQUAL(expected, val);
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_spsc_push(&queue, &push_val));
+        TEST_ASSERT_TRUE(queue.list.nodes <= (nodes + 2u));
+    }
+}
+
+void test_spsc_two_threads(void)
+{
+    pthread_t producer;
+    void *ret;
+    int expected = 0;
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&producer, NULL, _producer_thread, NULL));
+
+    while (expected < NUM_ITEMS)
+    {
+        int val;
+        ulist_status_e err = ulist_spsc_pop(&queue, &val);
+
+        if (ULIST_OK == err)
+        {
+            TEST_ASSERT_EQUAL(expected, val);
+            expected += 1;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(ULIST_END, err);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, pthread_join(producer, &ret));
+    TEST_ASSERT_NULL(ret);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spsc_null);
+    RUN_TEST(test_spsc_empty);
+    RUN_TEST(test_spsc_fifo_order);
+    RUN_TEST(test_spsc_nodes_recycled);
+    RUN_TEST(test_spsc_two_threads);
+    return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <string.h>
+
+#include "unity.h"
+
+#include "ulist_api.h"
+
+#define NODE_SIZE (8u)
+
+static ulist_t list;
+static ulist_stats_t stats;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _append(int num_items)
+{
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+}
+
+void test_ulist_stats_invalid_params(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_get_stats(NULL, &stats));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_get_stats(&list, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_reset_stats(NULL));
+}
+
+void test_ulist_stats_appends_allocate_nodes(void)
+{
+    _append(NODE_SIZE * 4);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(list.nodes, stats.nodes_allocated);
+    TEST_ASSERT_EQUAL(0u, stats.splits);
+    TEST_ASSERT_EQUAL(0u, stats.bytes_moved);
+    TEST_ASSERT_EQUAL(0u, stats.forward_crawls + stats.backward_crawls);
+}
+
+void test_ulist_stats_crawls(void)
+{
+    int val;
+
+    _append(NODE_SIZE * 10);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reset_stats(&list));
+
+    // Item in the 3rd node is found from the head, passing 2 nodes
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, NODE_SIZE * 2, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(1u, stats.forward_crawls);
+    TEST_ASSERT_EQUAL(2u, stats.nodes_crawled);
+
+    // Item in the 2nd last node is found from the tail, passing 1 node
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, NODE_SIZE * 8, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(1u, stats.backward_crawls);
+    TEST_ASSERT_EQUAL(3u, stats.nodes_crawled);
+}
+
+void test_ulist_stats_split(void)
+{
+    int val = -1;
+
+    _append(NODE_SIZE * 2);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reset_stats(&list));
+
+    // First node is full, so it is split in two
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, 1u, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(1u, stats.splits);
+    TEST_ASSERT_EQUAL(1u, stats.nodes_allocated);
+    TEST_ASSERT_EQUAL(1u, stats.balances);
+    TEST_ASSERT_TRUE(stats.bytes_moved >= ((NODE_SIZE / 2u) * sizeof(int)));
+}
+
+void test_ulist_stats_merge(void)
+{
+    int val;
+
+    _append(NODE_SIZE * 2);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reset_stats(&list));
+
+    // Empty the first node down to half, then the second node is merged in
+    while (2u == list.nodes)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, 0u, &val));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_stats(&list, &stats));
+    TEST_ASSERT_EQUAL(1u, stats.merges);
+    TEST_ASSERT_TRUE(stats.balances >= 1u);
+    TEST_ASSERT_TRUE(stats.bytes_moved > 0u);
+}
+
+void test_ulist_stats_reset(void)
+{
+    ulist_stats_t zero;
+
+    _append(NODE_SIZE * 4);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, NODE_SIZE, NULL));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_reset_stats(&list));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_stats(&list, &stats));
+
+    memset(&zero, 0, sizeof(zero));
+    TEST_ASSERT_EQUAL_MEMORY(&zero, &stats, sizeof(stats));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_stats_invalid_params);
+    RUN_TEST(test_ulist_stats_appends_allocate_nodes);
+    RUN_TEST(test_ulist_stats_crawls);
+    RUN_TEST(test_ulist_stats_split);
+    RUN_TEST(test_ulist_stats_merge);
+    RUN_TEST(test_ulist_stats_reset);
+    return UNITY_END();
+}
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+
+#include "ulist_api.h"
+#include "ulist_snapshot_api.h"
+
+#define EDGE_SIZE (4u)
+#define NODE_SIZE (64u)
+#define NUM_ITEMS (1000u)
+
+static ulist_t list;
+
+void setUp(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create_tiered(&list, sizeof(unsigned),
+                                                    EDGE_SIZE, NODE_SIZE));
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+static void _verify(unsigned *expected, unsigned long long num_items)
+{
+    TEST_ASSERT_EQUAL(num_items, list.num_items);
+
+    for (unsigned long long i = 0u; i < num_items; i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &item));
+        TEST_ASSERT_EQUAL(expected[i], item);
+    }
+
+    // Node links and counts must agree with each other
+    unsigned long long nodes = 0u;
+    unsigned long long items = 0u;
+
+    for (ulist_node_t *node = list.head; NULL != node; node = node->next)
+    {
+        TEST_ASSERT_TRUE(node->used <= node->capacity);
+        TEST_ASSERT_TRUE((node == list.head) || (node->previous->next == node));
+        nodes += 1u;
+        items += node->used;
+    }
+
+    TEST_ASSERT_EQUAL(list.nodes, nodes);
+    TEST_ASSERT_EQUAL(num_items, items);
+}
+
+void test_ulist_tiered_invalid_params(void)
+{
+    ulist_t other;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_tiered(NULL, 4u, EDGE_SIZE, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_tiered(&other, 0u, EDGE_SIZE, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_tiered(&other, 4u, 1u, NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_create_tiered(&other, 4u, NODE_SIZE, EDGE_SIZE));
+}
+
+void test_ulist_tiered_append(void)
+{
+    static unsigned expected[NUM_ITEMS];
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        expected[i] = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    _verify(expected, NUM_ITEMS);
+
+    // Small nodes at the ends, large nodes in between
+    TEST_ASSERT_EQUAL(EDGE_SIZE, list.head->capacity);
+    TEST_ASSERT_EQUAL(EDGE_SIZE, list.tail->capacity);
+
+    for (ulist_node_t *node = list.head->next; list.tail != node;
+         node = node->next)
+    {
+        TEST_ASSERT_EQUAL(NODE_SIZE, node->capacity);
+    }
+
+    TEST_ASSERT_TRUE(list.nodes < (2u + (NUM_ITEMS / (NODE_SIZE / 2u))));
+}
+
+void test_ulist_tiered_prepend(void)
+{
+    static unsigned expected[NUM_ITEMS];
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        expected[NUM_ITEMS - 1u - i] = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, 0u, &i));
+    }
+
+    _verify(expected, NUM_ITEMS);
+    TEST_ASSERT_EQUAL(EDGE_SIZE, list.head->capacity);
+    TEST_ASSERT_TRUE(list.nodes < (2u + (NUM_ITEMS / (NODE_SIZE / 2u))));
+}
+
+void test_ulist_tiered_random_edits(void)
+{
+    static unsigned expected[NUM_ITEMS];
+    unsigned long long num_items = 0u;
+
+    for (unsigned i = 0u; i < (4u * NUM_ITEMS); i++)
+    {
+        unsigned item = (unsigned) rand();
+        unsigned long long index = (0u == num_items)
+                                   ? 0u : (unsigned) rand() % num_items;
+
+        if ((num_items < NUM_ITEMS) && ((0u == num_items) || (rand() & 1)))
+        {
+            // Favour the ends, like deque traffic
+            index = (i & 2u) ? num_items : (i & 4u) ? 0u : index;
+
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, index, &item));
+            memmove(&expected[index + 1u], &expected[index],
+                    (num_items - index) * sizeof(unsigned));
+            expected[index] = item;
+            num_items += 1u;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, index, &item));
+            TEST_ASSERT_EQUAL(expected[index], item);
+            memmove(&expected[index], &expected[index + 1u],
+                    (num_items - index - 1u) * sizeof(unsigned));
+            num_items -= 1u;
+        }
+    }
+
+    _verify(expected, num_items);
+}
+
+void test_ulist_tiered_snapshot(void)
+{
+    static unsigned expected[NUM_ITEMS];
+    ulist_snapshot_t snapshot;
+
+    for (unsigned i = 0u; i < (NUM_ITEMS / 2u); i++)
+    {
+        expected[i] = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_acquire(&list, &snapshot));
+
+    // Flushing the tail into shared interior nodes must copy them first
+    for (unsigned i = NUM_ITEMS / 2u; i < NUM_ITEMS; i++)
+    {
+        expected[i] = i;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    _verify(expected, NUM_ITEMS);
+
+    for (unsigned i = 0u; i < (NUM_ITEMS / 2u); i++)
+    {
+        unsigned item;
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_get_item(&snapshot, i,
+                                                            &item));
+        TEST_ASSERT_EQUAL(i, item);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_snapshot_release(&snapshot));
+}
+
+void test_ulist_tiered_memory_report(void)
+{
+    ulist_memory_report_t report;
+    size_t node_size;
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_memory_report(&list, &report));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_node_size_bytes(&list, &node_size));
+
+    TEST_ASSERT_EQUAL(NUM_ITEMS * sizeof(unsigned), report.item_bytes);
+    TEST_ASSERT_TRUE(report.total_bytes < (list.nodes * node_size));
+}
+
+void test_ulist_tiered_clear(void)
+{
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    // Interior nodes can be kept, the head is small again afterwards
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 4u));
+    TEST_ASSERT_EQUAL(EDGE_SIZE, list.head->capacity);
+    TEST_ASSERT_EQUAL(4u, list.spare_nodes);
+
+    for (unsigned i = 0u; i < NUM_ITEMS; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+    }
+
+    TEST_ASSERT_EQUAL(0u, list.spare_nodes);
+
+    unsigned item;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, NUM_ITEMS - 1u, &item));
+    TEST_ASSERT_EQUAL(NUM_ITEMS - 1u, item);
+}
+
+int main(int argc, char *argv[])
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_tiered_invalid_params);
+    RUN_TEST(test_ulist_tiered_append);
+    RUN_TEST(test_ulist_tiered_prepend);
+    RUN_TEST(test_ulist_tiered_random_edits);
+    RUN_TEST(test_ulist_tiered_snapshot);
+    RUN_TEST(test_ulist_tiered_memory_report);
+    RUN_TEST(test_ulist_tiered_clear);
+    return UNITY_END();
+}
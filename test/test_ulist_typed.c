@@ -0,0 +1,182 @@
+#include "unity.h"
+
+#include "ulist_typed_api.h"
+
+#define NODE_SIZE (4u)
+#define HALF_FULL (2u)
+
+typedef struct {
+    int a;
+    double b;
+} pair_t;
+
+ULIST_DEFINE(intlist, int, NODE_SIZE)
+ULIST_DEFINE(pairlist, pair_t, NODE_SIZE)
+
+static intlist_t list;
+
+void setUp(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, intlist_create(&list));
+}
+
+void tearDown(void)
+{
+   TEST_ASSERT_EQUAL(ULIST_OK, intlist_destroy(&list));
+}
+
+void _verify_node_item_ratio(ulist_t *list)
+{
+    ulist_node_t *node = list->head;
+    size_t item_count = 0;
+    size_t node_count = 0;
+
+    while (NULL != node)
+    {
+        if (node != list->tail)
+        {
+            TEST_ASSERT_TRUE(node->used >= HALF_FULL);
+        }
+
+        item_count += node->used;
+        node_count += 1u;
+        node = node->next;
+    }
+
+    TEST_ASSERT_EQUAL(list->num_items, item_count);
+    TEST_ASSERT_EQUAL(list->nodes, node_count);
+}
+
+void test_typed_null(void)
+{
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, intlist_create(NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, intlist_append(NULL, 1));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, intlist_get(NULL, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, intlist_get(&list, 0u, NULL));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, intlist_pop(NULL, 0u, &val));
+}
+
+void test_typed_out_of_range(void)
+{
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, intlist_get(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, intlist_pop(&list, 0u, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_append(&list, 5));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, intlist_get(&list, 1u, &val));
+    TEST_ASSERT_EQUAL(ULIST_INDEX_OUT_OF_RANGE, intlist_pop(&list, 1u, &val));
+}
+
+void test_typed_append_get(void)
+{
+    int num_items = 1000;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_append(&list, i));
+        _verify_node_item_ratio(&list.list);
+    }
+
+    TEST_ASSERT_EQUAL(num_items, intlist_size(&list));
+
+    for (int i = 0; i < num_items; i++)
+    {
+        int val;
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_get(&list, i, &val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+}
+
+void test_typed_insert_pop(void)
+{
+    int num_items = 200;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_insert(&list, i / 2, i));
+        _verify_node_item_ratio(&list.list);
+    }
+
+    // Pop from the tail, then the middle, then the head
+    while (intlist_size(&list) > 0u)
+    {
+        unsigned long long size = intlist_size(&list);
+        unsigned long long index = (size % 3u == 0u) ? size - 1u
+                                 : (size % 3u == 1u) ? size / 2u : 0u;
+        int expected;
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list.list, index, &expected));
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_pop(&list, index, &val));
+        TEST_ASSERT_EQUAL(expected, val);
+        TEST_ASSERT_EQUAL(size - 1u, intlist_size(&list));
+        _verify_node_item_ratio(&list.list);
+    }
+}
+
+void test_typed_iteration(void)
+{
+    int num_items = 100;
+    int *val;
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_append(&list, i));
+    }
+
+    for (int i = 0; i < num_items; i++)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_get_next(&list, &val));
+        TEST_ASSERT_EQUAL(i, *val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, intlist_get_next(&list, &val));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, intlist_set_iteration_start_index(&list, 50u));
+    for (int i = 50; i >= 0; i--)
+    {
+        TEST_ASSERT_EQUAL(ULIST_OK, intlist_get_previous(&list, &val));
+        TEST_ASSERT_EQUAL(i, *val);
+    }
+
+    TEST_ASSERT_EQUAL(ULIST_END, intlist_get_previous(&list, &val));
+}
+
+void test_typed_struct_items(void)
+{
+    pairlist_t pairs;
+    int num_items = 100;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, pairlist_create(&pairs));
+
+    for (int i = 0; i < num_items; i++)
+    {
+        pair_t p = {.a = i, .b = i * 0.5};
+        TEST_ASSERT_EQUAL(ULIST_OK, pairlist_append(&pairs, p));
+    }
+
+    for (int i = 0; i < num_items; i++)
+    {
+        pair_t p;
+        TEST_ASSERT_EQUAL(ULIST_OK, pairlist_pop(&pairs, 0u, &p));
+        TEST_ASSERT_EQUAL(i, p.a);
+        TEST_ASSERT_EQUAL_FLOAT(i * 0.5, p.b);
+    }
+
+    TEST_ASSERT_EQUAL(0u, pairlist_size(&pairs));
+    TEST_ASSERT_EQUAL(ULIST_OK, pairlist_destroy(&pairs));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_typed_null);
+    RUN_TEST(test_typed_out_of_range);
+    RUN_TEST(test_typed_append_get);
+    RUN_TEST(test_typed_insert_pop);
+    RUN_TEST(test_typed_iteration);
+    RUN_TEST(test_typed_struct_items);
+    return UNITY_END();
+}
@@ -0,0 +1,339 @@
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include "unity.h"
+
+#include "ulist_wal_api.h"
+
+#define NODE_SIZE (8u)
+#define NUM_ITEMS (500)
+
+static char dir[] = "/tmp/ulist_wal_XXXXXX";
+static char path[64];
+static char snapshot_path[80];
+static ulist_t list;
+static int expected[NUM_ITEMS * 2];
+static unsigned long long num_expected;
+
+void setUp(void)
+{
+    strcpy(dir + sizeof(dir) - 7u, "XXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(dir));
+    snprintf(path, sizeof(path), "%s/list.log", dir);
+    snprintf(snapshot_path, sizeof(snapshot_path), "%s.snap", path);
+    num_expected = 0u;
+}
+
+void tearDown(void)
+{
+    unlink(path);
+    unlink(snapshot_path);
+    rmdir(dir);
+}
+
+static void _open(size_t group_bytes, size_t compact_bytes)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_wal_open(&list, path, sizeof(int),
+                      NODE_SIZE, group_bytes, compact_bytes));
+}
+
+static void _insert(unsigned long long index, int val)
+{
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_insert_item(&list, index, &val));
+
+    for (unsigned long long i = num_expected; i > index; i--)
+    {
+        expected[i] = expected[i - 1u];
+    }
+
+    expected[index] = val;
+    num_expected += 1u;
+}
+
+static void _pop(unsigned long long index)
+{
+    int val;
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_pop_item(&list, index, &val));
+    TEST_ASSERT_EQUAL(expected[index], val);
+
+    for (unsigned long long i = index; (i + 1u) < num_expected; i++)
+    {
+        expected[i] = expected[i + 1u];
+    }
+
+    num_expected -= 1u;
+}
+
+// Make a mix of appends, inserts and pops
+static void _modify(int seed)
+{
+    srand(seed);
+
+    for (int i = 0; i < NUM_ITEMS; i++)
+    {
+        if (0 == (i % 3))
+        {
+            TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &i));
+            expected[num_expected++] = i;
+        }
+        else
+        {
+            _insert((unsigned long long) rand() % (num_expected + 1u), i);
+        }
+
+        if (0 == (i % 4))
+        {
+            _pop((unsigned long long) rand() % num_expected);
+        }
+    }
+}
+
+static void _verify(void)
+{
+    TEST_ASSERT_EQUAL(num_expected, list.num_items);
+
+    for (unsigned long long i = 0u; i < num_expected; i++)
+    {
+        int val;
+
+        TEST_ASSERT_EQUAL(ULIST_OK, ulist_get_item(&list, i, &val));
+        TEST_ASSERT_EQUAL(expected[i], val);
+    }
+}
+
+static off_t _file_size(const char *file_path)
+{
+    struct stat st;
+
+    TEST_ASSERT_EQUAL(0, stat(file_path, &st));
+    return st.st_size;
+}
+
+void test_ulist_wal_invalid_params(void)
+{
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_wal_open(NULL, path, sizeof(int), NODE_SIZE, 0, 0));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_wal_open(&list, NULL, sizeof(int), NODE_SIZE, 0, 0));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM,
+                      ulist_wal_open(&list, path, 0u, NODE_SIZE, 0, 0));
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_create(&list, sizeof(int), NODE_SIZE));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_wal_sync(&list));
+    TEST_ASSERT_EQUAL(ULIST_INVALID_PARAM, ulist_wal_compact(&list));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_recover_after_reopen(void)
+{
+    _open(0u, 0u);
+    _modify(1);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    _modify(2);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_group_commit(void)
+{
+    int val = 7;
+
+    _open(4096u, 0u);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &val));
+    expected[num_expected++] = val;
+
+    // Record is still buffered
+    off_t empty_size = _file_size(path);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_wal_sync(&list));
+    TEST_ASSERT_TRUE(_file_size(path) > empty_size);
+
+    _modify(3);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(4096u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_torn_record_is_dropped(void)
+{
+    int val = 1234;
+
+    _open(0u, 0u);
+    _modify(4);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &val));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    // Cut the last record short, as if the process died while writing it
+    off_t size = _file_size(path);
+    TEST_ASSERT_EQUAL(0, truncate(path, size - 2));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_TRUE(_file_size(path) < (size - 2));
+
+    // New records go after the last good one
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_append_item(&list, &val));
+    expected[num_expected++] = val;
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_compact(void)
+{
+    _open(0u, 0u);
+    _modify(5);
+    off_t log_size = _file_size(path);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_wal_compact(&list));
+    TEST_ASSERT_TRUE(_file_size(path) < log_size);
+    TEST_ASSERT_TRUE(_file_size(snapshot_path) > 0);
+
+    _modify(6);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_automatic_compaction(void)
+{
+    _open(256u, 4096u);
+    _modify(7);
+
+    // Log never grows much past the compaction size
+    TEST_ASSERT_TRUE(_file_size(snapshot_path) > 0);
+    TEST_ASSERT_TRUE(_file_size(path) < (4096 + 256 + 64));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(256u, 4096u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_crash_during_compaction(void)
+{
+    _open(0u, 0u);
+    _modify(8);
+
+    // Keep a copy of the log from before compaction
+    off_t size = _file_size(path);
+    char *old_log = malloc(size);
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_EQUAL(size, fread(old_log, 1, size, file));
+    fclose(file);
+
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_wal_compact(&list));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    // Snapshot was renamed into place, but the log was never emptied
+    file = fopen(path, "wb");
+    TEST_ASSERT_EQUAL(size, fwrite(old_log, 1, size, file));
+    fclose(file);
+    free(old_log);
+
+    _open(0u, 0u);
+    _verify();
+    _modify(9);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_clear_is_logged(void)
+{
+    _open(0u, 0u);
+    _modify(11);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_clear(&list, 2u));
+    num_expected = 0u;
+    _modify(12);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+void test_ulist_wal_item_size_mismatch(void)
+{
+    ulist_t other;
+
+    _open(0u, 0u);
+    _modify(10);
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT,
+                      ulist_wal_open(&other, path, sizeof(long long), NODE_SIZE,
+                                     0u, 0u));
+    TEST_ASSERT_EQUAL(ULIST_ERROR_FORMAT,
+                      ulist_wal_open(&other, path, sizeof(int), NODE_SIZE * 2u,
+                                     0u, 0u));
+}
+
+void test_ulist_wal_write_error_is_not_durable(void)
+{
+    struct rlimit old_limit;
+    struct rlimit limit;
+
+    _open(0u, 0u);
+    _modify(7);
+
+    // Writes that would grow the log fail with EFBIG instead of a signal
+    TEST_ASSERT_EQUAL(0, getrlimit(RLIMIT_FSIZE, &old_limit));
+    limit = old_limit;
+    limit.rlim_cur = (rlim_t) _file_size(path);
+    signal(SIGXFSZ, SIG_IGN);
+    TEST_ASSERT_EQUAL(0, setrlimit(RLIMIT_FSIZE, &limit));
+
+    int val = -1;
+    ulist_status_e err = ulist_append_item(&list, &val);
+
+    TEST_ASSERT_EQUAL(0, setrlimit(RLIMIT_FSIZE, &old_limit));
+    signal(SIGXFSZ, SIG_DFL);
+
+    // The append is done, and its record is written out by the next sync
+    TEST_ASSERT_EQUAL(ULIST_NOT_DURABLE, err);
+    expected[num_expected++] = val;
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_wal_sync(&list));
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+
+    _open(0u, 0u);
+    _verify();
+    TEST_ASSERT_EQUAL(ULIST_OK, ulist_destroy(&list));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ulist_wal_invalid_params);
+    RUN_TEST(test_ulist_wal_recover_after_reopen);
+    RUN_TEST(test_ulist_wal_group_commit);
+    RUN_TEST(test_ulist_wal_torn_record_is_dropped);
+    RUN_TEST(test_ulist_wal_compact);
+    RUN_TEST(test_ulist_wal_automatic_compaction);
+    RUN_TEST(test_ulist_wal_crash_during_compaction);
+    RUN_TEST(test_ulist_wal_clear_is_logged);
+    RUN_TEST(test_ulist_wal_item_size_mismatch);
+    RUN_TEST(test_ulist_wal_write_error_is_not_durable);
+    return UNITY_END();
+}